@@ -340,6 +340,19 @@ config {
       option "show_fps", false,
       option "skip_confirm_at_shop", false,
       option "skip_overcasting_warning", false,
+
+      -- Decoded sound effects kept in memory, in MiB.
+      option "sound_cache_size", {
+         default = 16,
+         min = 0,
+         max = 256,
+         is_hidden = true,
+      },
+
+      option "sound_cache_warm_up", {
+         default = true,
+         is_hidden = true,
+      },
    },
 
    -- Hidden sections
@@ -5,12 +5,46 @@
 #include "../elona/character.hpp"
 #include "../elona/debug.hpp"
 #include "../elona/event.hpp"
+#include "../elona/flow_field.hpp"
+#include "../elona/mapgen.hpp"
 #include "../elona/testing.hpp"
 #include "../elona/variables.hpp"
 #include "util.hpp"
 
 using namespace elona;
 
+
+
+namespace
+{
+
+// Builds the fields of NPCs chasing or fleeing from the player (the latter
+// needs the former), so that the benchmarks measure reusing their storage
+// rather than the first builds.
+void build_flow_fields()
+{
+    flow_fields.away_from(cdata.player().position);
+}
+
+
+
+// The movement, pathfinding and line-of-sight helpers run many times per NPC
+// turn and must not touch the heap.
+void run_npc_turns_without_allocations()
+{
+    const auto before =
+        count_allocations({"ai", "ai.flow_field", "fov", "cell"});
+    const auto npc_turns = run_npc_turns();
+    expect_allocations_per_npc_turn(
+        count_allocations({"ai", "ai.flow_field", "fov", "cell"}) - before,
+        npc_turns,
+        0);
+}
+
+} // namespace
+
+
+
 class AiFightFixture : public ::hayai::Fixture
 {
 public:
@@ -20,6 +54,7 @@ public:
         testing::start_in_debug_map();
         debug::voldemort = true;
         AddCharas(64);
+        build_flow_fields();
     }
 
     virtual void TearDown()
@@ -50,7 +85,7 @@ public:
 
 BENCHMARK_F(AiFightFixture, BenchAiFight64, 5, 50)
 {
-    run_npc_turns();
+    run_npc_turns_without_allocations();
 }
 
 
@@ -119,3 +154,50 @@ BENCHMARK_F(AiRagnarokFixture, BenchAiRagnarok, 5, 50)
 {
     run_npc_turns();
 }
+
+
+class AiMazeChaseFixture : public ::hayai::Fixture
+{
+public:
+    virtual void SetUp()
+    {
+        testing::pre_init();
+        testing::start_in_debug_map();
+        debug::voldemort = true;
+        generate_maze_floor(12);
+        rc = 0;
+        cxinit = -3;
+        chara_place();
+        AddCharas(100);
+        build_flow_fields();
+    }
+
+    virtual void TearDown()
+    {
+        for (auto&& chara : cdata.others())
+        {
+            chara_delete(chara.index);
+            chara.set_state(Character::State::empty);
+        }
+        testing::post_run();
+    }
+
+    void AddCharas(int amount)
+    {
+        for (int i = 0; i < amount; i++)
+        {
+            if (chara_create(-1, 328, -3, 0) == 0)
+            {
+                break;
+            }
+            cdata[rc].relationship = -3;
+            cdata[rc].original_relationship = -3;
+            cdata[rc].hate = 1000;
+        }
+    }
+};
+
+BENCHMARK_F(AiMazeChaseFixture, BenchAiMazeChase100, 5, 50)
+{
+    run_npc_turns_without_allocations();
+}
@@ -0,0 +1,86 @@
+#include "../thirdparty/hayai/hayai.hpp"
+
+#include <fstream>
+#include "../elona/autopick.hpp"
+#include "../elona/filesystem.hpp"
+#include "../elona/i18n.hpp"
+#include "../elona/item.hpp"
+#include "../elona/itemgen.hpp"
+#include "../elona/testing.hpp"
+#include "../elona/variables.hpp"
+
+using namespace elona;
+
+class AutopickFixture : public ::hayai::Fixture
+{
+public:
+    virtual void SetUp()
+    {
+        testing::pre_init();
+        testing::start_in_debug_map();
+        WriteRules(200);
+        Autopick::instance().load(playerid);
+        AddItems(400);
+    }
+
+    virtual void TearDown()
+    {
+        testing::post_run();
+    }
+
+    // Writes a rule file mixing item names, modifiers and categories in the
+    // proportions of a typical hand-written autopick file.
+    void WriteRules(int amount)
+    {
+        const auto separator = i18n::s.get("core.meta.word_separator");
+        const char* modifiers[] = {
+            "unknown", "cursed", "great", "miracle", "godly", "blessed"};
+        const char* categories[] = {
+            "armor", "melee_weapon", "potion", "scroll", "ring", "junk"};
+        const char* prefixes[] = {"", "~", "%", "=", "!", "%="};
+
+        std::ofstream out{
+            (filesystem::dirs::save(playerid) / "autopick.txt").native()};
+        for (int i = 0; i < amount; ++i)
+        {
+            out << prefixes[i % 6];
+            if (i % 3 == 0)
+            {
+                out << i18n::s.get(
+                           "core.autopick.modifier."s + modifiers[i % 6])
+                    << separator
+                    << i18n::s.get(
+                           "core.autopick.category."s + categories[i / 6 % 6]);
+            }
+            else
+            {
+                out << cnvitemname(i * 3 + 1);
+            }
+            if (i % 10 == 0)
+            {
+                out << ":core.ding2?";
+            }
+            out << std::endl;
+        }
+    }
+
+    void AddItems(int amount)
+    {
+        for (int i = 0; i < amount; ++i)
+        {
+            flt();
+            itemcreate(-1, 0, i % 50, i / 50 % 50, 0);
+        }
+    }
+};
+
+BENCHMARK_F(AutopickFixture, BenchAutopickGroundItems, 10, 100)
+{
+    for (const auto& item : inv.ground())
+    {
+        if (item.number() > 0)
+        {
+            Autopick::instance().get_operation(item);
+        }
+    }
+}
@@ -0,0 +1,89 @@
+#include "../thirdparty/hayai/hayai.hpp"
+
+#include "../elona/ability.hpp"
+#include "../elona/character.hpp"
+#include "../elona/debug.hpp"
+#include "../elona/enchantment.hpp"
+#include "../elona/item.hpp"
+#include "../elona/itemgen.hpp"
+#include "../elona/testing.hpp"
+#include "../elona/variables.hpp"
+
+using namespace elona;
+
+class CombatFixture : public ::hayai::Fixture
+{
+public:
+    virtual void SetUp()
+    {
+        testing::pre_init();
+        testing::start_in_debug_map();
+        debug::voldemort = true;
+        EquipAll(0);
+
+        const auto& pos = cdata.player().position;
+        chara_create(-1, 328, pos.x + 1, pos.y);
+        attacker = rc;
+        cdata[attacker].relationship = -3;
+    }
+
+    virtual void TearDown()
+    {
+        chara_delete(attacker);
+        testing::post_run();
+    }
+
+    // Fills every body part of the character with an item carrying several
+    // enchantments, as late-game equipment does.
+    void EquipAll(int cc)
+    {
+        for (int i = 0; i < 30; ++i)
+        {
+            if (cdata[cc].body_parts[i] == 0 ||
+                cdata[cc].body_parts[i] % 10000 != 0)
+            {
+                continue;
+            }
+            if (!itemcreate(cc, 1, -1, -1, 0))
+            {
+                break;
+            }
+            for (const auto id : {10010 + i % 8, 20050 + i % 10, 44, 52, 60012})
+            {
+                enchantment_add(inv[ci], id, 300, 0, false, false, true);
+            }
+            body = 100 + i;
+            equip_item(cc);
+        }
+        chara_refresh(cc);
+    }
+
+    int attacker = 0;
+};
+
+BENCHMARK_F(CombatFixture, BenchCombatMeleeAttack100, 5, 50)
+{
+    for (int i = 0; i < 100; ++i)
+    {
+        cc = attacker;
+        tc = 0;
+        distance = 1;
+        try_to_melee_attack();
+    }
+}
+
+BENCHMARK_F(CombatFixture, BenchCombatEnchantmentFind1000, 5, 50)
+{
+    int found = 0;
+    for (int i = 0; i < 1000; ++i)
+    {
+        for (const auto id : {22, 33, 34, 43, 48, 60010 + i % 10})
+        {
+            if (enchantment_find(cdata.player(), id))
+            {
+                ++found;
+            }
+        }
+    }
+    (void)found;
+}
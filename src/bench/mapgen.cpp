@@ -0,0 +1,155 @@
+#include "../thirdparty/hayai/hayai.hpp"
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <utility>
+#include "../elona/mapgen.hpp"
+#include "../elona/mdata.hpp"
+#include "../elona/testing.hpp"
+#include "../elona/variables.hpp"
+
+using namespace elona;
+
+
+
+namespace
+{
+
+using Clock = std::chrono::steady_clock;
+
+// Every floor gets its own seed, across runs too.
+int next_seed = 0;
+
+
+
+struct FloorStats
+{
+    int floors = 0;
+    int tries = 0;
+    double layout_seconds = 0;
+    double populate_seconds = 0;
+};
+
+
+
+// Prints the statistics of each floor type and dungeon level once all
+// benchmarks have run; hayai only reports the time per floor.
+struct FloorStatsReporter
+{
+    ~FloorStatsReporter()
+    {
+        if (stats.empty())
+        {
+            return;
+        }
+        std::cout << "Nefia floors (rdtype, level: floors/s, tries per floor, "
+                     "layout ms, populate ms):"
+                  << std::endl;
+        std::cout << std::fixed << std::setprecision(3);
+        for (const auto& pair : stats)
+        {
+            const auto& s = pair.second;
+            const auto seconds = s.layout_seconds + s.populate_seconds;
+            std::cout << "  " << pair.first.first << ", " << pair.first.second
+                      << ": " << (seconds > 0 ? s.floors / seconds : 0.0)
+                      << ", " << static_cast<double>(s.tries) / s.floors
+                      << ", " << s.layout_seconds * 1000 / s.floors << ", "
+                      << s.populate_seconds * 1000 / s.floors << std::endl;
+        }
+    }
+
+    std::map<std::pair<int, int>, FloorStats> stats;
+} floor_stats_reporter;
+
+
+
+double seconds_since(Clock::time_point start)
+{
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+} // namespace
+
+
+
+class MapgenFixture : public ::hayai::Fixture
+{
+public:
+    virtual void SetUp()
+    {
+        testing::pre_init();
+        testing::start_in_debug_map();
+    }
+
+    virtual void TearDown()
+    {
+        testing::post_run();
+    }
+
+    void GenerateFloor(int rdtype, int dungeon_level)
+    {
+        testing::prepare_nefia_floor(
+            static_cast<int>(mdata_t::MapId::lesimas),
+            dungeon_level,
+            next_seed++);
+        rdtry = 0;
+
+        auto& stats =
+            floor_stats_reporter.stats[std::make_pair(rdtype, dungeon_level)];
+
+        const auto layout_start = Clock::now();
+        const auto generated_rdtype = generate_random_nefia_layout(rdtype);
+        stats.layout_seconds += seconds_since(layout_start);
+
+        if (generated_rdtype)
+        {
+            const auto populate_start = Clock::now();
+            populate_random_nefia(*generated_rdtype);
+            stats.populate_seconds += seconds_since(populate_start);
+        }
+
+        ++stats.floors;
+        stats.tries += rdtry;
+    }
+};
+
+
+
+BENCHMARK_P_F(
+    MapgenFixture,
+    BenchNefiaFloor,
+    10,
+    100,
+    (int rdtype, int dungeon_level))
+{
+    GenerateFloor(rdtype, dungeon_level);
+}
+
+// Rooms and corridors (map_createroom, map_connectroom).
+BENCHMARK_P_INSTANCE(MapgenFixture, BenchNefiaFloor, (1, 1));
+BENCHMARK_P_INSTANCE(MapgenFixture, BenchNefiaFloor, (1, 20));
+BENCHMARK_P_INSTANCE(MapgenFixture, BenchNefiaFloor, (1, 50));
+BENCHMARK_P_INSTANCE(MapgenFixture, BenchNefiaFloor, (2, 1));
+BENCHMARK_P_INSTANCE(MapgenFixture, BenchNefiaFloor, (2, 20));
+BENCHMARK_P_INSTANCE(MapgenFixture, BenchNefiaFloor, (2, 50));
+BENCHMARK_P_INSTANCE(MapgenFixture, BenchNefiaFloor, (3, 1));
+BENCHMARK_P_INSTANCE(MapgenFixture, BenchNefiaFloor, (3, 20));
+BENCHMARK_P_INSTANCE(MapgenFixture, BenchNefiaFloor, (3, 50));
+BENCHMARK_P_INSTANCE(MapgenFixture, BenchNefiaFloor, (4, 1));
+BENCHMARK_P_INSTANCE(MapgenFixture, BenchNefiaFloor, (4, 20));
+BENCHMARK_P_INSTANCE(MapgenFixture, BenchNefiaFloor, (4, 50));
+BENCHMARK_P_INSTANCE(MapgenFixture, BenchNefiaFloor, (5, 1));
+BENCHMARK_P_INSTANCE(MapgenFixture, BenchNefiaFloor, (5, 20));
+BENCHMARK_P_INSTANCE(MapgenFixture, BenchNefiaFloor, (5, 50));
+BENCHMARK_P_INSTANCE(MapgenFixture, BenchNefiaFloor, (8, 1));
+BENCHMARK_P_INSTANCE(MapgenFixture, BenchNefiaFloor, (8, 20));
+BENCHMARK_P_INSTANCE(MapgenFixture, BenchNefiaFloor, (8, 50));
+// Mazes (mapgen_dig_maze).
+BENCHMARK_P_INSTANCE(MapgenFixture, BenchNefiaFloor, (9, 1));
+BENCHMARK_P_INSTANCE(MapgenFixture, BenchNefiaFloor, (9, 20));
+BENCHMARK_P_INSTANCE(MapgenFixture, BenchNefiaFloor, (9, 50));
+BENCHMARK_P_INSTANCE(MapgenFixture, BenchNefiaFloor, (10, 1));
+BENCHMARK_P_INSTANCE(MapgenFixture, BenchNefiaFloor, (10, 20));
+BENCHMARK_P_INSTANCE(MapgenFixture, BenchNefiaFloor, (10, 50));
@@ -0,0 +1,91 @@
+#include "../thirdparty/hayai/hayai.hpp"
+
+#include <iostream>
+#include "../elona/character.hpp"
+#include "../elona/filesystem.hpp"
+#include "../elona/item.hpp"
+#include "../elona/itemgen.hpp"
+#include "../elona/testing.hpp"
+#include "../elona/variables.hpp"
+
+using namespace elona;
+
+
+
+namespace
+{
+
+// Prints the size of the save written by the benchmarks once all of them
+// have run; hayai only reports the time.
+struct SaveSizeReporter
+{
+    ~SaveSizeReporter()
+    {
+        if (files == 0)
+        {
+            return;
+        }
+        std::cout << "Save size: " << bytes << " bytes in " << files
+                  << " files" << std::endl;
+    }
+
+    uintmax_t bytes = 0;
+    size_t files = 0;
+} save_size_reporter;
+
+
+
+void measure_save_size()
+{
+    save_size_reporter.bytes = 0;
+    save_size_reporter.files = 0;
+    for (const auto& entry :
+         fs::recursive_directory_iterator(filesystem::dirs::save(playerid)))
+    {
+        if (fs::is_regular_file(entry.path()))
+        {
+            save_size_reporter.bytes += fs::file_size(entry.path());
+            ++save_size_reporter.files;
+        }
+    }
+}
+
+} // namespace
+
+
+
+class SaveFixture : public ::hayai::Fixture
+{
+public:
+    virtual void SetUp()
+    {
+        testing::pre_init();
+        testing::start_in_debug_map();
+
+        // Fill part of the map, so that not every slot is empty.
+        for (int i = 0; i < 50; ++i)
+        {
+            flt();
+            chara_create(-1, 0, i, 0);
+            flt();
+            itemcreate(-1, 0, i, 1, 0);
+        }
+        testing::save();
+    }
+
+    virtual void TearDown()
+    {
+        testing::post_run();
+    }
+};
+
+BENCHMARK_F(SaveFixture, BenchSave, 10, 10)
+{
+    testing::save();
+    measure_save_size();
+}
+
+BENCHMARK_F(SaveFixture, BenchLoad, 10, 10)
+{
+    testing::load();
+}
@@ -0,0 +1,64 @@
+#include "../thirdparty/hayai/hayai.hpp"
+
+#include "../elona/audio.hpp"
+#include "../elona/buff.hpp"
+#include "../elona/character.hpp"
+#include "../elona/shared_id.hpp"
+#include "../elona/testing.hpp"
+
+using namespace elona;
+
+// Compares looking up a fixed ID from a string on every call with looking it
+// up from an interned `SharedId`.
+class SharedIdFixture : public ::hayai::Fixture
+{
+public:
+    static constexpr int calls = 1000;
+
+    virtual void SetUp()
+    {
+        testing::pre_init();
+        testing::start_in_debug_map();
+        found = 0;
+    }
+
+    virtual void TearDown()
+    {
+        testing::post_run();
+    }
+
+    // Keeps the lookups from being optimized away.
+    int found = 0;
+};
+
+BENCHMARK_F(SharedIdFixture, BenchBuffHasString, 10, 100)
+{
+    for (int i = 0; i < calls; ++i)
+    {
+        found += buff_has(cdata.player(), "core.hero");
+    }
+}
+
+BENCHMARK_F(SharedIdFixture, BenchBuffHasInterned, 10, 100)
+{
+    for (int i = 0; i < calls; ++i)
+    {
+        found += buff_has(cdata.player(), ELONA_SHARED_ID("core.hero"));
+    }
+}
+
+BENCHMARK_F(SharedIdFixture, BenchSndString, 10, 100)
+{
+    for (int i = 0; i < calls; ++i)
+    {
+        snd("core.foot1a");
+    }
+}
+
+BENCHMARK_F(SharedIdFixture, BenchSndInterned, 10, 100)
+{
+    for (int i = 0; i < calls; ++i)
+    {
+        snd(ELONA_SHARED_ID("core.foot1a"));
+    }
+}
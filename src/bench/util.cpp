@@ -1,11 +1,42 @@
+#include "util.hpp"
+#include <cstdlib>
+#include <iostream>
 #include "../elona/enums.hpp"
 #include "../elona/turn_sequence.hpp"
+#include "../util/allocation_profiler.hpp"
+
+namespace
+{
+
+// Prints the allocations of each subsystem once all benchmarks have run.
+struct AllocationReporter
+{
+    ~AllocationReporter()
+    {
+        const auto stats = lib::g_allocation_profiler.stats();
+        if (stats.empty())
+        {
+            return;
+        }
+        std::cout << "Allocations by subsystem:" << std::endl;
+        for (const auto& s : stats)
+        {
+            std::cout << "  " << s.subsystem << ": " << s.count << " ("
+                      << s.bytes << " bytes)" << std::endl;
+        }
+    }
+} allocation_reporter;
+
+} // namespace
+
+
 
 namespace elona
 {
 
-void run_npc_turns()
+int run_npc_turns()
 {
+    int npc_turns = 0;
     turn_begin();
     auto result = TurnResult::none;
     while (result != TurnResult::all_turns_finished)
@@ -16,8 +47,42 @@ void run_npc_turns()
         {
             npc_turn();
             turn_end();
+            ++npc_turns;
         }
     }
+    return npc_turns;
+}
+
+
+
+size_t count_allocations(std::initializer_list<const char*> subsystems)
+{
+    size_t total = 0;
+    for (const auto subsystem : subsystems)
+    {
+        total += lib::g_allocation_profiler.count(subsystem);
+    }
+    return total;
+}
+
+
+
+void expect_allocations_per_npc_turn(
+    size_t allocations,
+    int npc_turns,
+    double max_per_turn)
+{
+    if (npc_turns == 0)
+    {
+        return;
+    }
+    const auto per_turn = static_cast<double>(allocations) / npc_turns;
+    if (per_turn > max_per_turn)
+    {
+        std::cerr << "Too many allocations per NPC turn: " << per_turn
+                  << " (expected at most " << max_per_turn << ")" << std::endl;
+        std::abort();
+    }
 }
 
 } // namespace elona
@@ -1,7 +1,28 @@
 #pragma once
+#include <cstddef>
+#include <initializer_list>
 
 namespace elona
 {
 
-void run_npc_turns();
-}
+/**
+ * Runs every NPC turn until the player's next turn.
+ * @return the number of NPC turns run.
+ */
+int run_npc_turns();
+
+/**
+ * Returns the number of allocations counted for the given subsystems so far.
+ */
+size_t count_allocations(std::initializer_list<const char*> subsystems);
+
+/**
+ * Aborts the benchmark if more than @a max_per_turn allocations were made per
+ * NPC turn on average.
+ */
+void expect_allocations_per_npc_turn(
+    size_t allocations,
+    int npc_turns,
+    double max_per_turn);
+
+} // namespace elona
@@ -10,6 +10,7 @@
 #include "dmgheal.hpp"
 #include "enchantment.hpp"
 #include "fish.hpp"
+#include "flow_field.hpp"
 #include "food.hpp"
 #include "fov.hpp"
 #include "i18n.hpp"
@@ -1754,6 +1755,7 @@ void spot_mining_or_wall()
                 }
             }
             cell_data.at(refx, refy).chip_id_actual = tile_tunnel;
+            flow_fields.notify_cell_changed(refx, refy);
             spillfrag(refx, refy, 2);
             snd("core.crush1");
             BreakingAnimation({refx, refy}).play();
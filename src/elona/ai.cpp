@@ -1,4 +1,6 @@
 #include "ai.hpp"
+#include "../util/allocation_profiler.hpp"
+#include "../util/zone_profiler.hpp"
 #include "ability.hpp"
 #include "activity.hpp"
 #include "animation.hpp"
@@ -7,6 +9,7 @@
 #include "character_status.hpp"
 #include "command.hpp"
 #include "data/types/type_item.hpp"
+#include "flow_field.hpp"
 #include "fov.hpp"
 #include "i18n.hpp"
 #include "item.hpp"
@@ -40,19 +43,18 @@ enum class Direction
 
 
 
+constexpr int _dirchk[2][3] = {
+    {-1, 0, 1},
+    {1, 0, -1},
+};
+
+
+
 bool _ai_check(Character& chara, Direction direction, int p)
 {
     assert(p == 0 || p == 1);
 
-    elona_vector2<int> dirchk;
-    DIM3(dirchk, 3, 2);
-
-    dirchk(0, 0) = -1;
-    dirchk(1, 0) = 0;
-    dirchk(2, 0) = 1;
-    dirchk(0, 1) = 1;
-    dirchk(1, 1) = 0;
-    dirchk(2, 1) = -1;
+    ELONA_ALLOCATION_SCOPE("ai");
 
     for (int cnt = 0; cnt < 3; ++cnt)
     {
@@ -60,19 +62,19 @@ bool _ai_check(Character& chara, Direction direction, int p)
         {
         case Direction::south:
             chara.next_position.y = chara.position.y + 1;
-            chara.next_position.x = dirchk(cnt, p) + chara.position.x;
+            chara.next_position.x = _dirchk[p][cnt] + chara.position.x;
             break;
         case Direction::west:
             chara.next_position.x = chara.position.x - 1;
-            chara.next_position.y = dirchk(cnt, p) + chara.position.y;
+            chara.next_position.y = _dirchk[p][cnt] + chara.position.y;
             break;
         case Direction::east:
             chara.next_position.x = chara.position.x + 1;
-            chara.next_position.y = dirchk(cnt, p) + chara.position.y;
+            chara.next_position.y = _dirchk[p][cnt] + chara.position.y;
             break;
         case Direction::north:
             chara.next_position.y = chara.position.y - 1;
-            chara.next_position.x = dirchk(cnt, p) + chara.position.x;
+            chara.next_position.x = _dirchk[p][cnt] + chara.position.x;
             break;
         }
 
@@ -212,6 +214,58 @@ bool _ai_dir_check_y()
 
 
 
+// Steps along the shared flow field towards (or away from) the player. Used
+// when the direct step is blocked so that crowds walk around walls instead of
+// probing the neighboring cells every turn.
+bool _try_flow_field_step(Character& chara, bool away)
+{
+    ELONA_ALLOCATION_SCOPE("ai.flow_field");
+
+    const auto& field = away ? flow_fields.away_from(cdata.player().position)
+                             : flow_fields.towards(cdata.player().position);
+
+    int best = field.at(chara.position.x, chara.position.y);
+    if (best == FlowField::unreachable)
+    {
+        return false;
+    }
+
+    optional<Position> step;
+    for (int dy = -1; dy <= 1; ++dy)
+    {
+        for (int dx = -1; dx <= 1; ++dx)
+        {
+            const auto nx = chara.position.x + dx;
+            const auto ny = chara.position.y + dy;
+            const auto distance = field.at(nx, ny);
+            if (distance >= best)
+            {
+                continue;
+            }
+            cell_check(nx, ny);
+            if (cellchara != -1)
+            {
+                continue;
+            }
+            if (cellaccess != 1 && cellfeat != 21)
+            {
+                continue;
+            }
+            best = distance;
+            step = Position{nx, ny};
+        }
+    }
+
+    if (!step)
+    {
+        return false;
+    }
+    chara.next_position = *step;
+    return true;
+}
+
+
+
 // TODO: move it to random.hpp
 bool _percent(int percentage)
 {
@@ -593,6 +647,8 @@ namespace elona
 
 TurnResult ai_proc_basic(Character& chara)
 {
+    ELONA_PROFILE_ZONE("ai_proc_basic");
+
     if (tc == 0)
     {
         pcattacker = chara.index;
@@ -756,10 +812,14 @@ TurnResult proc_npc_movement_event(Character& chara, bool retreat)
         return TurnResult::turn_end;
     }
 
-    if (chara._203 <= 0)
+    const auto follows_target = chara._203 <= 0;
+    // tc is overwritten below by whoever blocks the next cell.
+    const auto follows_player = follows_target && tc == 0;
+    const auto flees = retreat || chara.ai_dist > distance;
+    if (follows_target)
     {
         chara.target_position = cdata[tc].position;
-        if (retreat || chara.ai_dist > distance)
+        if (flees)
         {
             chara.target_position.x =
                 chara.position.x + (chara.position.x - cdata[tc].position.x);
@@ -827,6 +887,7 @@ TurnResult proc_npc_movement_event(Character& chara, bool retreat)
         if (rnd(4) == 0)
         {
             cell_data.at(x, y).chip_id_actual = tile_tunnel;
+            flow_fields.notify_cell_changed(x, y);
             snd("core.crush1");
             BreakingAnimation({x, y}).play();
             spillfrag(x, y, 2);
@@ -838,6 +899,11 @@ TurnResult proc_npc_movement_event(Character& chara, bool retreat)
         }
     }
 
+    if (follows_player && _try_flow_field_step(chara, flees))
+    {
+        return proc_movement_event();
+    }
+
     if (std::abs(chara.target_position.x - chara.position.x) >=
         std::abs(chara.target_position.y - chara.position.y))
     {
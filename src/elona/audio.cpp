@@ -264,6 +264,42 @@ void _preload_sound_if_needed(const fs::path& filepath, int id)
     }
 }
 
+
+
+// Sounds of the temporary channels played on nearly every turn of a fight.
+void _warm_up_sound_cache()
+{
+    static const char* const sounds[] = {
+        "core.foot1a",
+        "core.foot1b",
+        "core.foot2a",
+        "core.foot2b",
+        "core.foot2c",
+        "core.kill1",
+        "core.kill2",
+        "core.get1",
+        "core.get2",
+        "core.atksword",
+        "core.bow1",
+        "core.atk_fire",
+        "core.atk_ice",
+        "core.atk_elec",
+        "core.atk_poison",
+        "core.ok1",
+        "core.fail1",
+        "core.inv",
+    };
+
+    for (const auto& id : sounds)
+    {
+        if (const auto sound = the_sound_db[id])
+        {
+            snail::audio::preload_sound(
+                filepathutil::to_utf8_path(sound->file));
+        }
+    }
+}
+
 } // namespace
 
 
@@ -348,6 +384,12 @@ void initialize_sound_file()
     {
         _preload_sound_if_needed(se.file, se.legacy_id);
     }
+
+    if (g_config.sound() && g_config.sound_cache_warm_up() &&
+        snail::audio::sound_cache_stats().budget > 0)
+    {
+        _warm_up_sound_cache();
+    }
 }
 
 std::pair<short, unsigned char> sound_calculate_position(
@@ -381,7 +423,7 @@ std::pair<short, unsigned char> sound_calculate_position(
 
 std::pair<short, unsigned char> sound_calculate_position(const Position& p)
 {
-    if (!config_get_boolean("core.screen.stereo_sound"))
+    if (!g_config.stereo_sound())
     {
         return {0, 0};
     }
@@ -507,16 +549,18 @@ optional<SharedId> sound_id_for_element(int element_id)
 
 void sound_kill(const Position& position)
 {
-    static const std::vector<std::string> sounds = {"core.kill1", "core.kill2"};
-    snd_at(SharedId(choice(sounds)), position, false, false);
+    static const std::vector<SharedId> sounds = {SharedId("core.kill1"),
+                                                 SharedId("core.kill2")};
+    snd_at(choice(sounds), position, false, false);
 }
 
 
 
 void sound_pick_up()
 {
-    static const std::vector<std::string> sounds = {"core.get1", "core.get2"};
-    snd(SharedId(choice(sounds)));
+    static const std::vector<SharedId> sounds = {SharedId("core.get1"),
+                                                 SharedId("core.get2")};
+    snd(choice(sounds));
 }
 
 
@@ -525,8 +569,8 @@ void sound_footstep(int foot)
 {
     switch (foot % 2)
     {
-    case 0: snd("core.foot1a"); break;
-    case 1: snd("core.foot1b"); break;
+    case 0: snd(ELONA_SHARED_ID("core.foot1a")); break;
+    case 1: snd(ELONA_SHARED_ID("core.foot1b")); break;
     }
 }
 
@@ -534,9 +578,9 @@ void sound_footstep2(int foot)
 {
     switch (foot % 3)
     {
-    case 0: snd("core.foot2a"); break;
-    case 1: snd("core.foot2b"); break;
-    case 2: snd("core.foot2c"); break;
+    case 0: snd(ELONA_SHARED_ID("core.foot2a")); break;
+    case 1: snd(ELONA_SHARED_ID("core.foot2b")); break;
+    case 2: snd(ELONA_SHARED_ID("core.foot2c")); break;
     }
 }
 
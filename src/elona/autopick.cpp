@@ -1,4 +1,6 @@
 #include "autopick.hpp"
+#include <deque>
+#include <tuple>
 #include "../util/fileutil.hpp"
 #include "../util/strutil.hpp"
 #include "data/types/type_item.hpp"
@@ -11,15 +13,6 @@
 namespace
 {
 
-struct ModifierMatchResult
-{
-    bool matched;
-    bool has_any_modifier;
-    std::string text_without_modifier;
-};
-
-
-
 struct ModifierMatcher
 {
     // It does not contain the prefix, "core.autopick.modifier."
@@ -109,41 +102,106 @@ std::vector<ModifierMatcher> _modifier_matchers = {
 
 
 
-ModifierMatchResult _check_modifiers(const std::string& text, const Item& item)
+// Finds the modifiers contained in `text`. Returns their indices in
+// `_modifier_matchers` and the text with them stripped.
+std::pair<std::vector<size_t>, std::string> _compile_modifiers(
+    const std::string& text)
 {
     const auto word_separator = i18n::s.get("core.meta.word_separator");
 
-    ModifierMatchResult result{
-        true, false, word_separator + text + word_separator};
+    std::vector<size_t> modifiers;
+    auto text_without_modifier = word_separator + text + word_separator;
 
-    for (const auto& matcher : _modifier_matchers)
+    for (size_t i = 0; i < _modifier_matchers.size(); ++i)
     {
         const auto word = word_separator +
-            i18n::s.get("core.autopick.modifier."s + matcher.locale_key) +
+            i18n::s.get("core.autopick.modifier."s +
+                        _modifier_matchers[i].locale_key) +
             word_separator;
-        if (strutil::contains(result.text_without_modifier, word))
+        if (strutil::contains(text_without_modifier, word))
         {
-            if (matcher.predicate(item))
-            {
-                result.text_without_modifier = strutil::replace(
-                    result.text_without_modifier, word, word_separator);
-                result.has_any_modifier = true;
-            }
-            else
-            {
-                return {false, true, text};
-            }
+            text_without_modifier =
+                strutil::replace(text_without_modifier, word, word_separator);
+            modifiers.push_back(i);
         }
     }
 
-    return result;
+    return {modifiers, text_without_modifier};
+}
+
+} // namespace
+
+
+
+namespace elona
+{
+
+Autopick& Autopick::instance()
+{
+    static Autopick the_instance;
+    return the_instance;
+}
+
+
+
+void Autopick::load(const std::string& player_id)
+{
+    _clear();
+
+    // Priority: save/xxx/autopick > save/autopick > /autopick
+    for (const auto directory : {filesystem::dirs::save(player_id),
+                                 filesystem::dirs::save(),
+                                 filesystem::dirs::exe()})
+    {
+        for (const auto filename :
+             {u8"autopick", u8"autopick.txt", u8"autopick.txt.txt"})
+        {
+            const auto filepath = directory / filename;
+            bool file_exists = _try_load(filepath);
+            if (file_exists)
+                break;
+        }
+    }
+
+    _compile();
+}
+
+
+
+void Autopick::_clear()
+{
+    matchers.clear();
+    name_matches.clear();
+    compiled_language = -1;
+}
+
+
+
+void Autopick::_compile()
+{
+    std::vector<std::string> name_patterns;
+    for (auto&& m : matchers)
+    {
+        std::tie(m.modifiers, m.text_without_modifier) =
+            _compile_modifiers(m.text);
+        std::tie(m.category_rule, m.category) =
+            _compile_category(m.text_without_modifier);
+        m.pattern = name_patterns.size();
+        name_patterns.push_back(m.text_without_modifier);
+    }
+    patterns.build(name_patterns);
+
+    // Item names depend on the language.
+    name_matches.clear();
+    compiled_language = jp;
 }
 
 
 
-bool _check_category(const std::string& text, const Item& item)
+// Finds the first category name contained in `text`.
+std::pair<Autopick::CategoryRule, int> Autopick::_compile_category(
+    const std::string& text)
 {
-    const auto category = the_item_db[itemid2int(item.id)]->category;
     const auto word_separator = i18n::s.get("core.meta.word_separator");
     const auto text_ = word_separator + text + word_separator;
 
@@ -154,7 +212,7 @@ bool _check_category(const std::string& text, const Item& item)
                 i18n::s.get("core.autopick.category." #locale_key) + \
                 word_separator)) \
     { \
-        return category == expected_category; \
+        return {CategoryRule::exact, expected_category}; \
     }
 
     if (strutil::contains(
@@ -162,14 +220,14 @@ bool _check_category(const std::string& text, const Item& item)
             word_separator + i18n::s.get("core.autopick.category.item") +
                 word_separator))
     {
-        return true;
+        return {CategoryRule::any, 0};
     }
     if (strutil::contains(
             text_,
             word_separator + i18n::s.get("core.autopick.category.equipment") +
                 word_separator))
     {
-        return category < 50000;
+        return {CategoryRule::equipment, 0};
     }
 
     ELONA_AUTOPICK_CATEGORY(melee_weapon, 10000)
@@ -205,49 +263,7 @@ bool _check_category(const std::string& text, const Item& item)
     ELONA_AUTOPICK_CATEGORY(cargo, 92000)
 
 #undef ELONA_AUTOPICK_CATEGORY
-    return false;
-}
-
-} // namespace
-
-
-
-namespace elona
-{
-
-Autopick& Autopick::instance()
-{
-    static Autopick the_instance;
-    return the_instance;
-}
-
-
-
-void Autopick::load(const std::string& player_id)
-{
-    _clear();
-
-    // Priority: save/xxx/autopick > save/autopick > /autopick
-    for (const auto directory : {filesystem::dirs::save(player_id),
-                                 filesystem::dirs::save(),
-                                 filesystem::dirs::exe()})
-    {
-        for (const auto filename :
-             {u8"autopick", u8"autopick.txt", u8"autopick.txt.txt"})
-        {
-            const auto filepath = directory / filename;
-            bool file_exists = _try_load(filepath);
-            if (file_exists)
-                break;
-        }
-    }
-}
-
-
-
-void Autopick::_clear()
-{
-    matchers.clear();
+    return {CategoryRule::none, 0};
 }
 
 
@@ -349,9 +365,14 @@ bool Autopick::_try_load(const fs::path& filepath)
 
 Autopick::Operation Autopick::get_operation(const Item& ci)
 {
+    if (compiled_language != jp)
+    {
+        _compile();
+    }
+
     for (const auto& m : matchers)
     {
-        if (m.matches(ci))
+        if (_matches(m, ci))
         {
             return m.op;
         }
@@ -362,36 +383,153 @@ Autopick::Operation Autopick::get_operation(const Item& ci)
 
 
 
-bool Autopick::Matcher::matches(const Item& ci) const
+const std::vector<char>& Autopick::_get_name_matches(int item_id)
+{
+    if (static_cast<size_t>(item_id) >= name_matches.size())
+    {
+        name_matches.resize(static_cast<size_t>(item_id) + 1);
+    }
+    auto& result = name_matches[static_cast<size_t>(item_id)];
+    if (result.empty())
+    {
+        result.assign(matchers.size(), 0);
+        patterns.find_all(cnvitemname(item_id), result);
+    }
+    return result;
+}
+
+
+
+bool Autopick::_matches(const Matcher& m, const Item& ci)
 {
     /* Check modifiers. */
-    const auto modifier_match_result = _check_modifiers(text, ci);
-    if (!modifier_match_result.matched)
+    for (const auto index : m.modifiers)
     {
-        return false;
+        if (!_modifier_matchers[index].predicate(ci))
+        {
+            return false;
+        }
     }
 
     /* Check item's name. */
-    const auto item_name = cnvitemname(itemid2int(ci.id));
     // You have to know that the item is known as the name to match by the name.
     const auto you_know_the_name =
         ci.identify_state != IdentifyState::unidentified;
-    const auto item_name_matched_with_text = you_know_the_name &&
-        strutil::contains(item_name,
-                          modifier_match_result.text_without_modifier);
-
-    if (item_name_matched_with_text)
+    if (you_know_the_name && _get_name_matches(itemid2int(ci.id))[m.pattern])
     {
         return true;
     }
 
     /* Check item category. */
-    if (!modifier_match_result.has_any_modifier)
+    if (m.modifiers.empty())
     {
         return false;
     }
 
-    return _check_category(modifier_match_result.text_without_modifier, ci);
+    switch (m.category_rule)
+    {
+    case CategoryRule::none: return false;
+    case CategoryRule::any: return true;
+    case CategoryRule::equipment:
+        return the_item_db[itemid2int(ci.id)]->category < 50000;
+    case CategoryRule::exact:
+        return the_item_db[itemid2int(ci.id)]->category == m.category;
+    default: return false;
+    }
+}
+
+
+
+void Autopick::PatternSet::build(const std::vector<std::string>& patterns)
+{
+    nodes.assign(1, Node{});
+    pattern_count = patterns.size();
+
+    // Build the trie.
+    for (size_t i = 0; i < patterns.size(); ++i)
+    {
+        size_t state = 0;
+        for (const auto c : patterns[i])
+        {
+            const auto key = static_cast<unsigned char>(c);
+            const auto it = nodes[state].next.find(key);
+            if (it != nodes[state].next.end())
+            {
+                state = it->second;
+            }
+            else
+            {
+                nodes.emplace_back();
+                nodes[state].next.emplace(key, nodes.size() - 1);
+                state = nodes.size() - 1;
+            }
+        }
+        nodes[state].outputs.push_back(i);
+    }
+
+    // Compute failure links in BFS order, merging the outputs of each node's
+    // failure target into it.
+    std::deque<size_t> queue{0};
+    while (!queue.empty())
+    {
+        const auto parent = queue.front();
+        queue.pop_front();
+        for (const auto& pair : nodes[parent].next)
+        {
+            const auto key = pair.first;
+            const auto child = pair.second;
+
+            size_t fail = nodes[parent].fail;
+            while (fail != 0 && nodes[fail].next.count(key) == 0)
+            {
+                fail = nodes[fail].fail;
+            }
+            const auto it = nodes[fail].next.find(key);
+            nodes[child].fail =
+                (it != nodes[fail].next.end() && it->second != child)
+                ? it->second
+                : 0;
+
+            const auto& inherited = nodes[nodes[child].fail].outputs;
+            nodes[child].outputs.insert(
+                nodes[child].outputs.end(), inherited.begin(), inherited.end());
+            queue.push_back(child);
+        }
+    }
+}
+
+
+
+void Autopick::PatternSet::find_all(
+    const std::string& text,
+    std::vector<char>& matched) const
+{
+    assert(matched.size() >= pattern_count);
+
+    // Empty patterns are contained in any text.
+    for (const auto output : nodes[0].outputs)
+    {
+        matched[output] = 1;
+    }
+
+    size_t state = 0;
+    for (const auto c : text)
+    {
+        const auto key = static_cast<unsigned char>(c);
+        while (state != 0 && nodes[state].next.count(key) == 0)
+        {
+            state = nodes[state].fail;
+        }
+        const auto it = nodes[state].next.find(key);
+        if (it != nodes[state].next.end())
+        {
+            state = it->second;
+        }
+        for (const auto output : nodes[state].outputs)
+        {
+            matched[output] = 1;
+        }
+    }
 }
 
 } // namespace elona
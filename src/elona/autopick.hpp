@@ -1,6 +1,8 @@
 #pragma once
 
+#include <map>
 #include <string>
+#include <vector>
 #include "../util/noncopyable.hpp"
 #include "filesystem.hpp"
 #include "item.hpp"
@@ -45,6 +47,42 @@ public:
 
 
 private:
+    /**
+     * Aho-Corasick automaton over the item name patterns of all rules, so
+     * that one pass over an item's name finds every rule it matches.
+     */
+    class PatternSet
+    {
+    public:
+        void build(const std::vector<std::string>& patterns);
+
+        // Sets `matched[i]` to 1 for each pattern `i` contained in `text`.
+        void find_all(const std::string& text, std::vector<char>& matched)
+            const;
+
+
+    private:
+        struct Node
+        {
+            std::map<unsigned char, size_t> next;
+            size_t fail = 0;
+            std::vector<size_t> outputs;
+        };
+
+        std::vector<Node> nodes;
+        size_t pattern_count = 0;
+    };
+
+
+    enum class CategoryRule
+    {
+        none,
+        any,
+        equipment,
+        exact,
+    };
+
+
     struct Matcher
     {
         Matcher(const std::string& text, const Operation& op)
@@ -56,17 +94,36 @@ private:
         std::string text;
         Operation op;
 
-        bool matches(const Item&) const;
+        // The fields below are computed from `text` by `_compile()`.
+
+        // Indices of the modifiers in `text`, all of which must hold.
+        std::vector<size_t> modifiers;
+        // `text` with the modifiers stripped.
+        std::string text_without_modifier;
+        // Index of `text_without_modifier` in the pattern set.
+        size_t pattern = 0;
+        CategoryRule category_rule = CategoryRule::none;
+        int category = 0;
     };
 
 
     std::vector<Matcher> matchers;
+    PatternSet patterns;
+    // Results of the pattern set for each item ID's name, computed lazily.
+    std::vector<std::vector<char>> name_matches;
+    int compiled_language = -1;
+
     Autopick() = default;
 
 
     void _clear();
     bool _try_load(const fs::path&);
     Matcher _parse_each_line(std::string line);
+    void _compile();
+    static std::pair<CategoryRule, int> _compile_category(
+        const std::string& text);
+    const std::vector<char>& _get_name_matches(int item_id);
+    bool _matches(const Matcher&, const Item&);
 };
 
 
@@ -891,7 +891,7 @@ label_1928_internal:
             break;
         }
         p = list(0, p);
-        s = itemname(p, inv[p].number());
+        s = item_name_cache.get(p, inv[p].number());
         s = strmid(s, 0, 28);
         if (p >= ELONA_ITEM_ON_GROUND_INDEX)
         {
@@ -99,7 +99,7 @@ void buff_apply(Character& chara, int id, int power)
 
 
 
-bool buff_has(const Character& chara, const std::string& id)
+bool buff_has(const Character& chara, const SharedId& id)
 {
     auto buff_def = the_buff_db[id];
     assert(buff_def);
@@ -111,9 +111,14 @@ bool buff_has(const Character& chara, const std::string& id)
 
 
 
-optional_ref<const Buff> buff_find(
-    const Character& chara,
-    const std::string& id)
+bool buff_has(const Character& chara, const std::string& id)
+{
+    return buff_has(chara, SharedId(id));
+}
+
+
+
+optional_ref<const Buff> buff_find(const Character& chara, const SharedId& id)
 {
     auto buff_def = the_buff_db[id];
     assert(buff_def);
@@ -133,6 +138,15 @@ optional_ref<const Buff> buff_find(
 
 
 
+optional_ref<const Buff> buff_find(
+    const Character& chara,
+    const std::string& id)
+{
+    return buff_find(chara, SharedId(id));
+}
+
+
+
 void buff_add(
     Character& chara,
     const std::string& id,
@@ -188,7 +202,8 @@ void buff_add(
         {
             resists = true;
         }
-        if (const auto& holy_veil = buff_find(chara, "core.holy_veil"))
+        if (const auto& holy_veil =
+                buff_find(chara, ELONA_SHARED_ID("core.holy_veil")))
         {
             if (holy_veil->power + 50 > power * 5 / 2 ||
                 rnd(holy_veil->power + 50) > rnd(power + 1))
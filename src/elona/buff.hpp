@@ -3,6 +3,7 @@
 #include <unordered_map>
 #include "data/types/type_buff.hpp"
 #include "optional.hpp"
+#include "shared_id.hpp"
 
 
 
@@ -19,7 +20,9 @@ std::string buff_get_description(int id, int power);
 
 void buff_apply(Character& chara, int id, int power);
 
+bool buff_has(const Character& chara, const SharedId& id);
 bool buff_has(const Character& chara, const std::string& id);
+optional_ref<const Buff> buff_find(const Character& chara, const SharedId& id);
 optional_ref<const Buff> buff_find(
     const Character& chara,
     const std::string& id);
@@ -12,6 +12,7 @@
 #include "data/types/type_item.hpp"
 #include "data/types/type_map.hpp"
 #include "draw.hpp"
+#include "flow_field.hpp"
 #include "i18n.hpp"
 #include "input.hpp"
 #include "input_prompt.hpp"
@@ -680,6 +681,7 @@ void fill_tile(int x, int y, int from, int to)
     // Draw one tile.
     cell_data.at(x, y).chip_id_actual = tile;
     cell_data.at(x, y).chip_id_memory = tile;
+    flow_fields.notify_cell_changed(x, y);
 
     // Draw tiles around.
     fill_tile(x - 1, y, from, to);
@@ -732,6 +734,7 @@ void start_home_map_mode()
         {
             cell_data.at(tlocx, tlocy).chip_id_actual = tile;
             cell_data.at(tlocx, tlocy).chip_id_memory = tile;
+            flow_fields.notify_cell_changed(tlocx, tlocy);
         }
         tlocinitx = tlocx;
         tlocinity = tlocy;
@@ -1,3 +1,4 @@
+#include "../util/zone_profiler.hpp"
 #include "area.hpp"
 #include "character.hpp"
 #include "config.hpp"
@@ -1378,6 +1379,8 @@ namespace elona
 
 void cell_draw()
 {
+    ELONA_PROFILE_ZONE("cell_draw");
+
     int scrturnbk_ = 0;
     int scrturnnew_ = 0;
     elona_vector1<int> p_;
@@ -1,5 +1,7 @@
 #include "character.hpp"
+#include <bitset>
 #include <cassert>
+#include <stdexcept>
 #include <type_traits>
 #include "../util/fileutil.hpp"
 #include "../util/range.hpp"
@@ -13,8 +15,11 @@
 #include "class.hpp"
 #include "ctrl_file.hpp"
 #include "data/types/type_item.hpp"
+#include "debug.hpp"
+#include "derived_stats.hpp"
 #include "elona.hpp"
 #include "equipment.hpp"
+#include "flow_field.hpp"
 #include "fov.hpp"
 #include "i18n.hpp"
 #include "item.hpp"
@@ -350,6 +355,7 @@ bool chara_place_internal(
                     if (chip_data.for_cell(x, y).effect & 4)
                     {
                         cell_data.at(x, y).chip_id_actual = tile_tunnel;
+                        flow_fields.notify_cell_changed(x, y);
                     }
                     // Delete someone there.
                     // TODO: Work around. Need delete him/her *completely*.
@@ -440,6 +446,379 @@ void failed_to_place_character(Character& cc)
     }
 }
 
+
+
+/**
+ * The original equipment pass of chara_refresh(), which decodes every
+ * enchantment of every equipped item. Kept as the reference implementation
+ * for debug::check_chara_refresh.
+ */
+void _refresh_equipment_stats_fully(int cc)
+{
+    int rp = 0;
+    int rp2 = 0;
+    int rp3 = 0;
+    for (int i = 0; i < 30; ++i)
+    {
+        if (cdata[cc].body_parts[i] % 10000 == 0)
+        {
+            continue;
+        }
+        rp = cdata[cc].body_parts[i] % 10000 - 1;
+        cdata[cc].sum_of_equipment_weight += inv[rp].weight;
+        if (inv[rp].skill == 168)
+        {
+            if (!(cdata[cc].equipment_type & 1))
+            {
+                cdata[cc].equipment_type += 1;
+            }
+        }
+        cdata[cc].dv += inv[rp].dv;
+        cdata[cc].pv += inv[rp].pv;
+        if (inv[rp].dice_x == 0)
+        {
+            cdata[cc].hit_bonus += inv[rp].hit_bonus;
+            cdata[cc].damage_bonus += inv[rp].damage_bonus;
+            cdata[cc].pv += inv[rp].enhancement * 2 +
+                (inv[rp].curse_state == CurseState::blessed) * 2;
+        }
+        else if (cdata[cc].body_parts[i] / 10000 == 5)
+        {
+            ++attacknum;
+        }
+        if (inv[rp].curse_state == CurseState::cursed)
+        {
+            cdata[cc].curse_power += 20;
+        }
+        if (inv[rp].curse_state == CurseState::doomed)
+        {
+            cdata[cc].curse_power += 100;
+        }
+        if (inv[rp].material == 8)
+        {
+            if (cc == 0)
+            {
+                game_data.ether_disease_speed += 5;
+            }
+        }
+        for (int cnt = 0; cnt < 15; ++cnt)
+        {
+            if (inv[rp].enchantments[cnt].id == 0)
+            {
+                break;
+            }
+            rp2 = inv[rp].enchantments[cnt].id;
+            if (rp2 >= 10000)
+            {
+                rp3 = rp2 % 10000;
+                rp2 = rp2 / 10000;
+                if (rp2 == 1)
+                {
+                    sdata(rp3, cc) += inv[rp].enchantments[cnt].power / 50 + 1;
+                    continue;
+                }
+                if (rp2 == 2)
+                {
+                    sdata(rp3, cc) += inv[rp].enchantments[cnt].power / 2;
+                    if (sdata(rp3, cc) < 0)
+                    {
+                        sdata(rp3, cc) = 1;
+                    }
+                    continue;
+                }
+                if (rp2 == 3)
+                {
+                    if (sdata.get(rp3, cc).original_level != 0)
+                    {
+                        sdata(rp3, cc) +=
+                            inv[rp].enchantments[cnt].power / 50 + 1;
+                        if (sdata(rp3, cc) < 1)
+                        {
+                            sdata(rp3, cc) = 1;
+                        }
+                    }
+                    continue;
+                }
+            }
+            else
+            {
+                if (rp2 == 56)
+                {
+                    if (cc == 0)
+                    {
+                        game_data.catches_god_signal = 1;
+                        continue;
+                    }
+                }
+                if (rp2 == 59)
+                {
+                    if (cc == 0)
+                    {
+                        game_data.reveals_religion = 1;
+                        continue;
+                    }
+                }
+                if (rp2 == 29)
+                {
+                    sdata(18, cc) += inv[rp].enchantments[cnt].power / 50 + 1;
+                    if (cc == 0)
+                    {
+                        game_data.seven_league_boot_effect +=
+                            inv[rp].enchantments[cnt].power / 8;
+                        continue;
+                    }
+                }
+                if (rp2 == 32)
+                {
+                    cdata[cc].is_floating() = true;
+                    continue;
+                }
+                if (rp2 == 35)
+                {
+                    cdata[cc].can_see_invisible() = true;
+                    continue;
+                }
+                if (rp2 == 23)
+                {
+                    cdata[cc].is_immune_to_blindness() = true;
+                    continue;
+                }
+                if (rp2 == 24)
+                {
+                    cdata[cc].is_immune_to_paralyzation() = true;
+                    continue;
+                }
+                if (rp2 == 25)
+                {
+                    cdata[cc].is_immune_to_confusion() = true;
+                    continue;
+                }
+                if (rp2 == 26)
+                {
+                    cdata[cc].is_immune_to_fear() = true;
+                    continue;
+                }
+                if (rp2 == 27)
+                {
+                    cdata[cc].is_immune_to_sleep() = true;
+                    continue;
+                }
+                if (rp2 == 28)
+                {
+                    cdata[cc].is_immune_to_poison() = true;
+                    continue;
+                }
+                if (rp2 == 42)
+                {
+                    cdata[cc].can_digest_rotten_food() = true;
+                    continue;
+                }
+                if (rp2 == 41)
+                {
+                    cdata[cc].is_protected_from_thieves() = true;
+                    continue;
+                }
+                if (rp2 == 55)
+                {
+                    cdata[cc].cures_bleeding_quickly() = true;
+                    continue;
+                }
+                if (rp2 == 52)
+                {
+                    cdata[cc].decrease_physical_damage +=
+                        inv[rp].enchantments[cnt].power / 40 + 5;
+                    continue;
+                }
+                if (rp2 == 53)
+                {
+                    cdata[cc].nullify_damage +=
+                        inv[rp].enchantments[cnt].power / 60 + 3;
+                    continue;
+                }
+                if (rp2 == 54)
+                {
+                    cdata[cc].cut_counterattack +=
+                        inv[rp].enchantments[cnt].power / 5;
+                    continue;
+                }
+                if (rp2 == 44)
+                {
+                    cdata[cc].rate_of_critical_hit +=
+                        inv[rp].enchantments[cnt].power / 50;
+                    continue;
+                }
+                if (rp2 == 39)
+                {
+                    cdata[cc].rate_to_pierce +=
+                        inv[rp].enchantments[cnt].power / 50;
+                    continue;
+                }
+                if (rp2 == 50)
+                {
+                    cdata[cc].extra_attack +=
+                        inv[rp].enchantments[cnt].power / 15;
+                    continue;
+                }
+                if (rp2 == 51)
+                {
+                    cdata[cc].extra_shot +=
+                        inv[rp].enchantments[cnt].power / 15;
+                    cdata[cc].extra_shot = 100;
+                    continue;
+                }
+                if (rp2 == 21 || rp2 == 45 || rp2 == 46 || rp2 == 47)
+                {
+                    cdata[cc].has_cursed_equipments() = true;
+                    continue;
+                }
+                if (cc == 0)
+                {
+                    if (rp2 == 30)
+                    {
+                        game_data.protects_from_etherwind = 1;
+                        continue;
+                    }
+                    if (rp2 == 31)
+                    {
+                        game_data.protects_from_bad_weather = 1;
+                        continue;
+                    }
+                }
+            }
+        }
+    }
+}
+
+
+
+void _refresh_equipment_stats(int cc)
+{
+    for (int i = 0; i < 30; ++i)
+    {
+        if (cdata[cc].body_parts[i] % 10000 == 0)
+        {
+            continue;
+        }
+        const auto& item = inv[cdata[cc].body_parts[i] % 10000 - 1];
+        const auto is_in_hand = cdata[cc].body_parts[i] / 10000 == 5;
+        const auto& contribution =
+            equipment_contribution_cache.get(cc, i, item, is_in_hand);
+        contribution.apply_to(cdata[cc]);
+        if (contribution.is_attack_weapon)
+        {
+            ++attacknum;
+        }
+    }
+}
+
+
+
+// Everything the equipment pass of chara_refresh() writes to.
+struct EquipmentStats
+{
+    std::vector<int> skills;
+    std::bitset<sizeof(int) * 8 * 50> flags;
+    std::vector<int> values;
+
+
+    static EquipmentStats capture(int cc)
+    {
+        EquipmentStats ret;
+        for (int i = 0; i < 600; ++i)
+        {
+            ret.skills.push_back(sdata(i, cc));
+        }
+        ret.flags = cdata[cc]._flags;
+        ret.values = {
+            cdata[cc].sum_of_equipment_weight,
+            cdata[cc].equipment_type,
+            cdata[cc].dv,
+            cdata[cc].pv,
+            cdata[cc].hit_bonus,
+            cdata[cc].damage_bonus,
+            cdata[cc].curse_power,
+            cdata[cc].rate_to_pierce,
+            cdata[cc].rate_of_critical_hit,
+            cdata[cc].extra_attack,
+            cdata[cc].extra_shot,
+            cdata[cc].decrease_physical_damage,
+            cdata[cc].nullify_damage,
+            cdata[cc].cut_counterattack,
+            attacknum,
+            game_data.ether_disease_speed,
+            game_data.seven_league_boot_effect,
+            game_data.catches_god_signal,
+            game_data.reveals_religion,
+            game_data.protects_from_etherwind,
+            game_data.protects_from_bad_weather,
+        };
+        return ret;
+    }
+
+
+    void restore(int cc) const
+    {
+        for (int i = 0; i < 600; ++i)
+        {
+            sdata(i, cc) = skills[static_cast<size_t>(i)];
+        }
+        cdata[cc]._flags = flags;
+        auto it = values.begin();
+        cdata[cc].sum_of_equipment_weight = *it++;
+        cdata[cc].equipment_type = *it++;
+        cdata[cc].dv = *it++;
+        cdata[cc].pv = *it++;
+        cdata[cc].hit_bonus = *it++;
+        cdata[cc].damage_bonus = *it++;
+        cdata[cc].curse_power = *it++;
+        cdata[cc].rate_to_pierce = *it++;
+        cdata[cc].rate_of_critical_hit = *it++;
+        cdata[cc].extra_attack = *it++;
+        cdata[cc].extra_shot = *it++;
+        cdata[cc].decrease_physical_damage = *it++;
+        cdata[cc].nullify_damage = *it++;
+        cdata[cc].cut_counterattack = *it++;
+        attacknum = *it++;
+        game_data.ether_disease_speed = *it++;
+        game_data.seven_league_boot_effect = *it++;
+        game_data.catches_god_signal = *it++;
+        game_data.reveals_religion = *it++;
+        game_data.protects_from_etherwind = *it++;
+        game_data.protects_from_bad_weather = *it++;
+    }
+
+
+    bool operator==(const EquipmentStats& other) const
+    {
+        return skills == other.skills && flags == other.flags &&
+            values == other.values;
+    }
+};
+
+
+
+/**
+ * Runs both the cached and the full equipment pass and throws if they
+ * disagree. The state left behind is the one of the full pass.
+ */
+void _check_equipment_stats(int cc)
+{
+    const auto before = EquipmentStats::capture(cc);
+    _refresh_equipment_stats(cc);
+    const auto cached = EquipmentStats::capture(cc);
+
+    before.restore(cc);
+    _refresh_equipment_stats_fully(cc);
+    const auto full = EquipmentStats::capture(cc);
+
+    if (!(cached == full))
+    {
+        throw std::runtime_error(
+            u8"chara_refresh: cached equipment stats of character "s +
+            std::to_string(cc) + u8" differ from a full refresh"s);
+    }
+}
+
 } // namespace
 
 
@@ -664,8 +1043,6 @@ int chara_create(int slot, int chara_id, int x, int y)
 void chara_refresh(int cc)
 {
     int rp = 0;
-    int rp2 = 0;
-    int rp3 = 0;
     if (cc == 0)
     {
         game_data.seven_league_boot_effect = 0;
@@ -712,10 +1089,10 @@ void chara_refresh(int cc)
     }
     else
     {
+        const auto data = the_character_db[charaid2int(cdata[cc].id)];
         for (size_t i = 0; i < 32 * 30; ++i)
         {
-            cdata[cc]._flags[i] =
-                the_character_db[charaid2int(cdata[cc].id)]->_flags[i];
+            cdata[cc]._flags[i] = data->_flags[i];
         }
     }
     for (auto&& growth_buff : cdata[cc].growth_buffs)
@@ -737,234 +1114,14 @@ void chara_refresh(int cc)
     cdata[cc].decrease_physical_damage = 0;
     cdata[cc].nullify_damage = 0;
     cdata[cc].cut_counterattack = 0;
-    for (int i = 0; i < 30; ++i)
+    equipped_enchantments.invalidate(cc);
+    if (debug::check_chara_refresh)
     {
-        if (cdata[cc].body_parts[i] % 10000 == 0)
-        {
-            continue;
-        }
-        rp = cdata[cc].body_parts[i] % 10000 - 1;
-        cdata[cc].sum_of_equipment_weight += inv[rp].weight;
-        if (inv[rp].skill == 168)
-        {
-            if (!(cdata[cc].equipment_type & 1))
-            {
-                cdata[cc].equipment_type += 1;
-            }
-        }
-        cdata[cc].dv += inv[rp].dv;
-        cdata[cc].pv += inv[rp].pv;
-        if (inv[rp].dice_x == 0)
-        {
-            cdata[cc].hit_bonus += inv[rp].hit_bonus;
-            cdata[cc].damage_bonus += inv[rp].damage_bonus;
-            cdata[cc].pv += inv[rp].enhancement * 2 +
-                (inv[rp].curse_state == CurseState::blessed) * 2;
-        }
-        else if (cdata[cc].body_parts[i] / 10000 == 5)
-        {
-            ++attacknum;
-        }
-        if (inv[rp].curse_state == CurseState::cursed)
-        {
-            cdata[cc].curse_power += 20;
-        }
-        if (inv[rp].curse_state == CurseState::doomed)
-        {
-            cdata[cc].curse_power += 100;
-        }
-        if (inv[rp].material == 8)
-        {
-            if (cc == 0)
-            {
-                game_data.ether_disease_speed += 5;
-            }
-        }
-        for (int cnt = 0; cnt < 15; ++cnt)
-        {
-            if (inv[rp].enchantments[cnt].id == 0)
-            {
-                break;
-            }
-            rp2 = inv[rp].enchantments[cnt].id;
-            if (rp2 >= 10000)
-            {
-                rp3 = rp2 % 10000;
-                rp2 = rp2 / 10000;
-                if (rp2 == 1)
-                {
-                    sdata(rp3, cc) += inv[rp].enchantments[cnt].power / 50 + 1;
-                    continue;
-                }
-                if (rp2 == 2)
-                {
-                    sdata(rp3, cc) += inv[rp].enchantments[cnt].power / 2;
-                    if (sdata(rp3, cc) < 0)
-                    {
-                        sdata(rp3, cc) = 1;
-                    }
-                    continue;
-                }
-                if (rp2 == 3)
-                {
-                    if (sdata.get(rp3, cc).original_level != 0)
-                    {
-                        sdata(rp3, cc) +=
-                            inv[rp].enchantments[cnt].power / 50 + 1;
-                        if (sdata(rp3, cc) < 1)
-                        {
-                            sdata(rp3, cc) = 1;
-                        }
-                    }
-                    continue;
-                }
-            }
-            else
-            {
-                if (rp2 == 56)
-                {
-                    if (cc == 0)
-                    {
-                        game_data.catches_god_signal = 1;
-                        continue;
-                    }
-                }
-                if (rp2 == 59)
-                {
-                    if (cc == 0)
-                    {
-                        game_data.reveals_religion = 1;
-                        continue;
-                    }
-                }
-                if (rp2 == 29)
-                {
-                    sdata(18, cc) += inv[rp].enchantments[cnt].power / 50 + 1;
-                    if (cc == 0)
-                    {
-                        game_data.seven_league_boot_effect +=
-                            inv[rp].enchantments[cnt].power / 8;
-                        continue;
-                    }
-                }
-                if (rp2 == 32)
-                {
-                    cdata[cc].is_floating() = true;
-                    continue;
-                }
-                if (rp2 == 35)
-                {
-                    cdata[cc].can_see_invisible() = true;
-                    continue;
-                }
-                if (rp2 == 23)
-                {
-                    cdata[cc].is_immune_to_blindness() = true;
-                    continue;
-                }
-                if (rp2 == 24)
-                {
-                    cdata[cc].is_immune_to_paralyzation() = true;
-                    continue;
-                }
-                if (rp2 == 25)
-                {
-                    cdata[cc].is_immune_to_confusion() = true;
-                    continue;
-                }
-                if (rp2 == 26)
-                {
-                    cdata[cc].is_immune_to_fear() = true;
-                    continue;
-                }
-                if (rp2 == 27)
-                {
-                    cdata[cc].is_immune_to_sleep() = true;
-                    continue;
-                }
-                if (rp2 == 28)
-                {
-                    cdata[cc].is_immune_to_poison() = true;
-                    continue;
-                }
-                if (rp2 == 42)
-                {
-                    cdata[cc].can_digest_rotten_food() = true;
-                    continue;
-                }
-                if (rp2 == 41)
-                {
-                    cdata[cc].is_protected_from_thieves() = true;
-                    continue;
-                }
-                if (rp2 == 55)
-                {
-                    cdata[cc].cures_bleeding_quickly() = true;
-                    continue;
-                }
-                if (rp2 == 52)
-                {
-                    cdata[cc].decrease_physical_damage +=
-                        inv[rp].enchantments[cnt].power / 40 + 5;
-                    continue;
-                }
-                if (rp2 == 53)
-                {
-                    cdata[cc].nullify_damage +=
-                        inv[rp].enchantments[cnt].power / 60 + 3;
-                    continue;
-                }
-                if (rp2 == 54)
-                {
-                    cdata[cc].cut_counterattack +=
-                        inv[rp].enchantments[cnt].power / 5;
-                    continue;
-                }
-                if (rp2 == 44)
-                {
-                    cdata[cc].rate_of_critical_hit +=
-                        inv[rp].enchantments[cnt].power / 50;
-                    continue;
-                }
-                if (rp2 == 39)
-                {
-                    cdata[cc].rate_to_pierce +=
-                        inv[rp].enchantments[cnt].power / 50;
-                    continue;
-                }
-                if (rp2 == 50)
-                {
-                    cdata[cc].extra_attack +=
-                        inv[rp].enchantments[cnt].power / 15;
-                    continue;
-                }
-                if (rp2 == 51)
-                {
-                    cdata[cc].extra_shot +=
-                        inv[rp].enchantments[cnt].power / 15;
-                    cdata[cc].extra_shot = 100;
-                    continue;
-                }
-                if (rp2 == 21 || rp2 == 45 || rp2 == 46 || rp2 == 47)
-                {
-                    cdata[cc].has_cursed_equipments() = true;
-                    continue;
-                }
-                if (cc == 0)
-                {
-                    if (rp2 == 30)
-                    {
-                        game_data.protects_from_etherwind = 1;
-                        continue;
-                    }
-                    if (rp2 == 31)
-                    {
-                        game_data.protects_from_bad_weather = 1;
-                        continue;
-                    }
-                }
-            }
-        }
+        _check_equipment_stats(cc);
+    }
+    else
+    {
+        _refresh_equipment_stats(cc);
     }
     if (refreshmode == 1)
     {
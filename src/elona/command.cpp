@@ -1694,6 +1694,7 @@ TurnResult do_use_command()
                     if (!enchantment_add(inv[ci], 45, 50))
                     {
                         inv[ci].enchantments[14].id = 0;
+                        enchantment_on_changed(inv[ci]);
                         txt(i18n::s.get(
                             "core.action.use.living.removes_enchantment",
                             inv[ci]));
@@ -1,4 +1,5 @@
 #include "config.hpp"
+#include <algorithm>
 #include <cassert>
 #include <fstream>
 #include <functional>
@@ -6,6 +7,7 @@
 #include <string>
 #include "../snail/android.hpp"
 #include "../snail/application.hpp"
+#include "../snail/audio.hpp"
 #include "../snail/touch_input.hpp"
 #include "../thirdparty/json5/json5.hpp"
 #include "../util/fps_counter.hpp"
@@ -119,13 +121,23 @@ void font_vertical_offset(const int& value)
 
 
 
-void foobar_show_fps(const bool&)
+void foobar_show_fps(const bool& value)
 {
+    g_config.set_show_fps(value);
+
     lib::g_fps_counter.clear();
 }
 
 
 
+void foobar_sound_cache_size(const int& megabytes)
+{
+    snail::audio::set_sound_cache_budget(
+        static_cast<size_t>(std::max(megabytes, 0)) * 1024 * 1024);
+}
+
+
+
 void game_default_save(const std::string& value)
 {
     elona::defload = value;
@@ -378,6 +390,9 @@ void bind_setters()
         +[](const type& value) { g_config.set_##name(value); })
 
     // clang-format off
+    CONFIG_OPTION("android.quicksave", bool, quicksave);
+    CONFIG_OPTION("android.vibrate", bool, vibrate);
+    CONFIG_OPTION("android.vibrate_duration", int, vibrate_duration);
     CONFIG_OPTION("anime.alert_wait", int, alert_wait);
     CONFIG_OPTION("anime.always_center", bool, always_center);
     CONFIG_OPTION("anime.anime_wait", int, animation_wait);
@@ -407,6 +422,7 @@ void bind_setters()
     CONFIG_OPTION("foobar.pcc_graphic_scale", std::string, pcc_graphic_scale);
     CONFIG_OPTION("foobar.skip_confirm_at_shop", bool, skip_confirm_at_shop);
     CONFIG_OPTION("foobar.skip_overcasting_warning", bool, skip_overcasting_warning);
+    CONFIG_OPTION("foobar.sound_cache_warm_up", bool, sound_cache_warm_up);
     CONFIG_OPTION("foobar.startup_script", std::string, startup_script);
     CONFIG_OPTION("game.attack_neutral_npcs", bool, attack_neutral_npcs);
     CONFIG_OPTION("game.extra_help", bool, extra_help);
@@ -431,11 +447,13 @@ void bind_setters()
     CONFIG_OPTION("net.is_enabled", bool, net);
     CONFIG_OPTION("screen.display_mode", std::string, display_mode);
     CONFIG_OPTION("screen.heartbeat", bool, heartbeat);
+    CONFIG_OPTION("screen.heartbeat_threshold", int, heartbeat_threshold);
     CONFIG_OPTION("screen.high_quality_shadows", bool, high_quality_shadow);
     CONFIG_OPTION("screen.music", bool, music);
     CONFIG_OPTION("screen.object_shadows", bool, object_shadow);
     CONFIG_OPTION("screen.skip_random_event_popups", bool, skip_random_event_popups);
     CONFIG_OPTION("screen.sound", bool, sound);
+    CONFIG_OPTION("screen.stereo_sound", bool, stereo_sound);
     // clang-format on
 
     conf.bind_setter(
@@ -450,6 +468,8 @@ void bind_setters()
         "core.font.vertical_offset", &setters::font_vertical_offset);
     conf.bind_setter("core.game.default_save", &setters::game_default_save);
     conf.bind_setter("core.foobar.show_fps", &setters::foobar_show_fps);
+    conf.bind_setter(
+        "core.foobar.sound_cache_size", &setters::foobar_sound_cache_size);
     conf.bind_setter("core.screen.orientation", &setters::screen_orientation);
     conf.bind_setter("core.screen.fullscreen", &setters::screen_fullscreen);
 
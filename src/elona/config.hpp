@@ -89,6 +89,7 @@ public:
     ELONA_DEFINE_OPTION(snail::Window::FullscreenMode, fullscreen)
     ELONA_DEFINE_OPTION(int, general_wait)
     ELONA_DEFINE_OPTION(bool, heartbeat)
+    ELONA_DEFINE_OPTION(int, heartbeat_threshold)
     ELONA_DEFINE_OPTION(bool, hide_autoidentify)
     ELONA_DEFINE_OPTION(bool, hide_navigation)
     ELONA_DEFINE_OPTION(bool, hide_shop_updates)
@@ -109,6 +110,7 @@ public:
     ELONA_DEFINE_OPTION(std::string, pcc_graphic_scale)
     ELONA_DEFINE_OPTION(int, quick_action_size)
     ELONA_DEFINE_OPTION(int, quick_action_transparency)
+    ELONA_DEFINE_OPTION(bool, quicksave)
     ELONA_DEFINE_OPTION(int, restock_interval)
     ELONA_DEFINE_OPTION(int, run_wait)
     ELONA_DEFINE_OPTION(int, screen_refresh_wait)
@@ -117,14 +119,19 @@ public:
     ELONA_DEFINE_OPTION(int, select_fast_start_wait)
     ELONA_DEFINE_OPTION(int, select_fast_wait)
     ELONA_DEFINE_OPTION(int, select_wait)
+    ELONA_DEFINE_OPTION(bool, show_fps)
     ELONA_DEFINE_OPTION(bool, skip_confirm_at_shop)
     ELONA_DEFINE_OPTION(bool, skip_overcasting_warning)
     ELONA_DEFINE_OPTION(bool, skip_random_event_popups)
     ELONA_DEFINE_OPTION(bool, sound)
+    ELONA_DEFINE_OPTION(bool, sound_cache_warm_up)
     ELONA_DEFINE_OPTION(int, start_run_wait)
     ELONA_DEFINE_OPTION(std::string, startup_script)
+    ELONA_DEFINE_OPTION(bool, stereo_sound)
     ELONA_DEFINE_OPTION(bool, story)
     ELONA_DEFINE_OPTION(bool, title_effect)
+    ELONA_DEFINE_OPTION(bool, vibrate)
+    ELONA_DEFINE_OPTION(int, vibrate_duration)
     ELONA_DEFINE_OPTION(int, walk_wait)
     ELONA_DEFINE_OPTION(bool, weather_effect)
     ELONA_DEFINE_OPTION(bool, window_animation)
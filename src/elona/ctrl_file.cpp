@@ -1,13 +1,17 @@
 #include "ctrl_file.hpp"
+#include <functional>
 #include <set>
+#include <sstream>
 #include "../util/fileutil.hpp"
 #include "ability.hpp"
 #include "area.hpp"
 #include "character.hpp"
 #include "character_status.hpp"
 #include "deferred_event.hpp"
+#include "derived_stats.hpp"
 #include "elona.hpp"
 #include "filesystem.hpp"
+#include "food.hpp"
 #include "item.hpp"
 #include "log.hpp"
 #include "lua_env/handle_manager.hpp"
@@ -17,6 +21,7 @@
 #include "mef.hpp"
 #include "putit.hpp"
 #include "quest.hpp"
+#include "save_stream.hpp"
 #include "variables.hpp"
 
 using namespace elona;
@@ -31,6 +36,19 @@ elona_vector2<std::string> cdatan2;
 int elona_export;
 std::set<fs::path> loaded_files;
 
+// What save_if_changed() last wrote to each file. The size is that of the file
+// on disk, so that a file replaced behind our back is noticed. Every write
+// gets a new number, which tells Save::save() whether it copied that write.
+struct WrittenFile
+{
+    size_t hash;
+    uintmax_t size;
+    uint64_t write_number;
+};
+
+std::unordered_map<fs::path, WrittenFile> written_files;
+uint64_t last_write_number = 0;
+
 
 
 void arrayfile_read(const std::string& fmode_str, const fs::path& filepath)
@@ -197,6 +215,84 @@ void arrayfile(
 }
 
 
+// Whether the save file at @a filepath holds exactly @a data.
+bool file_holds(const fs::path& filepath, const std::string& data)
+{
+    SaveIFStream in{filepath};
+    if (in.fail())
+    {
+        return false;
+    }
+
+    std::string chunk(64 * 1024, '\0');
+    size_t offset = 0;
+    while (in)
+    {
+        in.read(&chunk[0], static_cast<std::streamsize>(chunk.size()));
+        const auto count = static_cast<size_t>(in.gcount());
+        if (count > data.size() - offset ||
+            data.compare(offset, count, chunk, 0, count) != 0)
+        {
+            return false;
+        }
+        offset += count;
+    }
+    return offset == data.size() && !in.bad();
+}
+
+
+/**
+ * Encodes save data with @a write and writes it to @a filepath, unless the
+ * file already holds exactly the same data. Visiting a map and leaving it
+ * again changes few of its files, so most of them need neither compressing nor
+ * writing, nor copying to the save directory later.
+ */
+template <typename F>
+void save_if_changed(const fs::path& filepath, F write)
+{
+    std::ostringstream buffer{std::ios::binary};
+    {
+        putit::BinaryOArchive ar{buffer};
+        write(ar);
+    }
+    const auto data = buffer.str();
+    const auto hash = std::hash<std::string>{}(data);
+
+    // The hash only tells changed data apart quickly. Data with the same hash
+    // is compared with the file byte by byte.
+    const auto itr = written_files.find(filepath);
+    if (itr != std::end(written_files) && itr->second.hash == hash &&
+        fs::exists(filepath) && fs::file_size(filepath) == itr->second.size &&
+        file_holds(filepath, data))
+    {
+        return;
+    }
+
+    // Until the new data is written completely, the file is not known to hold
+    // anything.
+    written_files.erase(filepath);
+    {
+        SaveOFStream out{filepath};
+        if (out.fail())
+        {
+            throw std::runtime_error(
+                u8"Could not open file at "s +
+                filepathutil::to_utf8_path(filepath));
+        }
+        out.write(data.data(), static_cast<std::streamsize>(data.size()));
+        out.close();
+        if (out.fail())
+        {
+            throw std::runtime_error(
+                u8"Could not write file at "s +
+                filepathutil::to_utf8_path(filepath));
+        }
+    }
+    written_files[filepath] = {
+        hash, fs::file_size(filepath), ++last_write_number};
+}
+
+
 template <typename T>
 void load_v1(
     const fs::path& filepath,
@@ -204,7 +300,7 @@ void load_v1(
     size_t begin,
     size_t end)
 {
-    std::ifstream in{filepath.native(), std::ios::binary};
+    SaveIFStream in{filepath};
     if (in.fail())
     {
         ELONA_FATAL("save")
@@ -229,18 +325,12 @@ void save_v1(
     size_t begin,
     size_t end)
 {
-    std::ofstream out{filepath.native(), std::ios::binary};
-    if (out.fail())
-    {
-        throw std::runtime_error(
-            u8"Could not open file at "s +
-            filepathutil::to_utf8_path(filepath));
-    }
-    putit::BinaryOArchive ar(out);
-    for (size_t i = begin; i < end; ++i)
-    {
-        ar(data(i));
-    }
+    save_if_changed(filepath, [&](putit::BinaryOArchive& ar) {
+        for (size_t i = begin; i < end; ++i)
+        {
+            ar(data(i));
+        }
+    });
 }
 
 
@@ -253,7 +343,7 @@ void load_v2(
     size_t j_begin,
     size_t j_end)
 {
-    std::ifstream in{filepath.native(), std::ios::binary};
+    SaveIFStream in{filepath};
     if (in.fail())
     {
         throw std::runtime_error(
@@ -280,21 +370,15 @@ void save_v2(
     size_t j_begin,
     size_t j_end)
 {
-    std::ofstream out{filepath.native(), std::ios::binary};
-    if (out.fail())
-    {
-        throw std::runtime_error(
-            u8"Could not open file at "s +
-            filepathutil::to_utf8_path(filepath));
-    }
-    putit::BinaryOArchive ar{out};
-    for (size_t j = j_begin; j < j_end; ++j)
-    {
-        for (size_t i = i_begin; i < i_end; ++i)
+    save_if_changed(filepath, [&](putit::BinaryOArchive& ar) {
+        for (size_t j = j_begin; j < j_end; ++j)
         {
-            ar(data(i, j));
+            for (size_t i = i_begin; i < i_end; ++i)
+            {
+                ar(data(i, j));
+            }
         }
-    }
+    });
 }
 
 
@@ -309,7 +393,7 @@ void load_v3(
     size_t k_begin,
     size_t k_end)
 {
-    std::ifstream in{filepath.native(), std::ios::binary};
+    SaveIFStream in{filepath};
     if (in.fail())
     {
         throw std::runtime_error(
@@ -341,31 +425,25 @@ void save_v3(
     size_t k_begin,
     size_t k_end)
 {
-    std::ofstream out{filepath.native(), std::ios::binary};
-    if (out.fail())
-    {
-        throw std::runtime_error(
-            u8"Could not open file at "s +
-            filepathutil::to_utf8_path(filepath));
-    }
-    putit::BinaryOArchive ar{out};
-    for (size_t k = k_begin; k < k_end; ++k)
-    {
-        for (size_t j = j_begin; j < j_end; ++j)
+    save_if_changed(filepath, [&](putit::BinaryOArchive& ar) {
+        for (size_t k = k_begin; k < k_end; ++k)
         {
-            for (size_t i = i_begin; i < i_end; ++i)
+            for (size_t j = j_begin; j < j_end; ++j)
             {
-                ar(data(i, j, k));
+                for (size_t i = i_begin; i < i_end; ++i)
+                {
+                    ar(data(i, j, k));
+                }
             }
         }
-    }
+    });
 }
 
 
 template <typename T>
 void load(const fs::path& filepath, T& data, size_t begin, size_t end)
 {
-    std::ifstream in{filepath.native(), std::ios::binary};
+    SaveIFStream in{filepath};
     if (in.fail())
     {
         throw std::runtime_error(
@@ -383,18 +461,12 @@ void load(const fs::path& filepath, T& data, size_t begin, size_t end)
 template <typename T>
 void save(const fs::path& filepath, T& data, size_t begin, size_t end)
 {
-    std::ofstream out{filepath.native(), std::ios::binary};
-    if (out.fail())
-    {
-        throw std::runtime_error(
-            u8"Could not open file at "s +
-            filepathutil::to_utf8_path(filepath));
-    }
-    putit::BinaryOArchive ar{out};
-    for (size_t i = begin; i < end; ++i)
-    {
-        ar(data[i]);
-    }
+    save_if_changed(filepath, [&](putit::BinaryOArchive& ar) {
+        for (size_t i = begin; i < end; ++i)
+        {
+            ar(data[i]);
+        }
+    });
 }
 
 
@@ -464,12 +536,15 @@ void fmode_7_8(bool read, const fs::path& dir)
         {
             if (fs::exists(filepath))
             {
-                putit::BinaryIArchive::load(filepath, foobar_data);
+                SaveIFStream in{filepath};
+                putit::BinaryIArchive::load(in, foobar_data);
             }
         }
         else
         {
-            putit::BinaryOArchive::save(filepath, foobar_data);
+            save_if_changed(filepath, [&](putit::BinaryOArchive& ar) {
+                ar(foobar_data);
+            });
         }
     }
 
@@ -498,7 +573,7 @@ void fmode_7_8(bool read, const fs::path& dir)
         {
             if (fs::exists(filepath))
             {
-                std::ifstream in{filepath.native(), std::ios::binary};
+                SaveIFStream in{filepath};
                 putit::BinaryIArchive ar{in};
                 for (int cc = 0; cc < ELONA_MAX_PARTY_CHARACTERS; ++cc)
                 {
@@ -511,15 +586,15 @@ void fmode_7_8(bool read, const fs::path& dir)
         }
         else
         {
-            std::ofstream out{filepath.native(), std::ios::binary};
-            putit::BinaryOArchive ar{out};
-            for (int cc = 0; cc < ELONA_MAX_PARTY_CHARACTERS; ++cc)
-            {
-                for (int i = 0; i < 600; ++i)
+            save_if_changed(filepath, [&](putit::BinaryOArchive& ar) {
+                for (int cc = 0; cc < ELONA_MAX_PARTY_CHARACTERS; ++cc)
                 {
-                    ar(sdata.get(i, cc));
+                    for (int i = 0; i < 600; ++i)
+                    {
+                        ar(sdata.get(i, cc));
+                    }
                 }
-            }
+            });
         }
     }
 
@@ -787,7 +862,7 @@ void fmode_7_8(bool read, const fs::path& dir)
         {
             if (fs::exists(filepath))
             {
-                std::ifstream in{filepath.native(), std::ios::binary};
+                SaveIFStream in{filepath};
                 putit::BinaryIArchive ar{in};
                 mod_serializer.load_mod_store_data(
                     ar, lua::ModInfo::StoreType::global);
@@ -795,10 +870,10 @@ void fmode_7_8(bool read, const fs::path& dir)
         }
         else
         {
-            std::ofstream out{filepath.native(), std::ios::binary};
-            putit::BinaryOArchive ar{out};
-            mod_serializer.save_mod_store_data(
-                ar, lua::ModInfo::StoreType::global);
+            save_if_changed(filepath, [&](putit::BinaryOArchive& ar) {
+                mod_serializer.save_mod_store_data(
+                    ar, lua::ModInfo::StoreType::global);
+            });
         }
     }
 
@@ -806,7 +881,7 @@ void fmode_7_8(bool read, const fs::path& dir)
         const auto filepath = dir / u8"mod_cdata.s1";
         if (read)
         {
-            std::ifstream in{filepath.native(), std::ios::binary};
+            SaveIFStream in{filepath};
             putit::BinaryIArchive ar{in};
             std::tie(index_start, index_end) =
                 mod_serializer.load_handles<Character>(
@@ -820,10 +895,10 @@ void fmode_7_8(bool read, const fs::path& dir)
         }
         else
         {
-            std::ofstream out{filepath.native(), std::ios::binary};
-            putit::BinaryOArchive ar{out};
-            mod_serializer.save_handles<Character>(
-                ar, lua::ModInfo::StoreType::global);
+            save_if_changed(filepath, [&](putit::BinaryOArchive& ar) {
+                mod_serializer.save_handles<Character>(
+                    ar, lua::ModInfo::StoreType::global);
+            });
         }
     }
 
@@ -831,7 +906,7 @@ void fmode_7_8(bool read, const fs::path& dir)
         const auto filepath = dir / u8"mod_inv.s1";
         if (read)
         {
-            std::ifstream in{filepath.native(), std::ios::binary};
+            SaveIFStream in{filepath};
             putit::BinaryIArchive ar{in};
             std::tie(index_start, index_end) =
                 mod_serializer.load_handles<Item>(
@@ -845,10 +920,10 @@ void fmode_7_8(bool read, const fs::path& dir)
         }
         else
         {
-            std::ofstream out{filepath.native(), std::ios::binary};
-            putit::BinaryOArchive ar{out};
-            mod_serializer.save_handles<Item>(
-                ar, lua::ModInfo::StoreType::global);
+            save_if_changed(filepath, [&](putit::BinaryOArchive& ar) {
+                mod_serializer.save_handles<Item>(
+                    ar, lua::ModInfo::StoreType::global);
+            });
         }
     }
 }
@@ -894,7 +969,7 @@ void fmode_14_15(bool read)
         {
             if (fs::exists(filepath))
             {
-                std::ifstream in{filepath.native(), std::ios::binary};
+                SaveIFStream in{filepath};
                 putit::BinaryIArchive ar{in};
                 for (int cc = 0; cc < ELONA_MAX_PARTY_CHARACTERS; ++cc)
                 {
@@ -908,15 +983,15 @@ void fmode_14_15(bool read)
         else
         {
             Save::instance().add(filepath.filename());
-            std::ofstream out{filepath.native(), std::ios::binary};
-            putit::BinaryOArchive ar{out};
-            for (int cc = 0; cc < ELONA_MAX_PARTY_CHARACTERS; ++cc)
-            {
-                for (int i = 0; i < 600; ++i)
+            save_if_changed(filepath, [&](putit::BinaryOArchive& ar) {
+                for (int cc = 0; cc < ELONA_MAX_PARTY_CHARACTERS; ++cc)
                 {
-                    ar(sdata.get(i, cc));
+                    for (int i = 0; i < 600; ++i)
+                    {
+                        ar(sdata.get(i, cc));
+                    }
                 }
-            }
+            });
         }
     }
 
@@ -1103,7 +1178,7 @@ void fmode_1_2(bool read)
         if (read)
         {
             tmpload(u8"sdata_"s + mid + u8".s2");
-            std::ifstream in{filepath.native(), std::ios::binary};
+            SaveIFStream in{filepath};
             putit::BinaryIArchive ar{in};
             for (int cc = ELONA_MAX_PARTY_CHARACTERS; cc < ELONA_MAX_CHARACTERS;
                  ++cc)
@@ -1118,16 +1193,17 @@ void fmode_1_2(bool read)
         {
             Save::instance().add(filepath.filename());
             writeloadedbuff(u8"sdata_"s + mid + u8".s2");
-            std::ofstream out{filepath.native(), std::ios::binary};
-            putit::BinaryOArchive ar{out};
-            for (int cc = ELONA_MAX_PARTY_CHARACTERS; cc < ELONA_MAX_CHARACTERS;
-                 ++cc)
-            {
-                for (int i = 0; i < 600; ++i)
+            save_if_changed(filepath, [&](putit::BinaryOArchive& ar) {
+                for (int cc = ELONA_MAX_PARTY_CHARACTERS;
+                     cc < ELONA_MAX_CHARACTERS;
+                     ++cc)
                 {
-                    ar(sdata.get(i, cc));
+                    for (int i = 0; i < 600; ++i)
+                    {
+                        ar(sdata.get(i, cc));
+                    }
                 }
-            }
+            });
         }
     }
 
@@ -1177,7 +1253,7 @@ void fmode_1_2(bool read)
         {
             tmpload(u8"mod_map_"s + mid + u8".s2");
 
-            std::ifstream in{filepath.native(), std::ios::binary};
+            SaveIFStream in{filepath};
             putit::BinaryIArchive ar{in};
             mod_serializer.load_mod_store_data(
                 ar, lua::ModInfo::StoreType::map);
@@ -1187,10 +1263,10 @@ void fmode_1_2(bool read)
             Save::instance().add(filepath.filename());
             writeloadedbuff(u8"mod_map_"s + mid + u8".s2");
 
-            std::ofstream out{filepath.native(), std::ios::binary};
-            putit::BinaryOArchive ar{out};
-            mod_serializer.save_mod_store_data(
-                ar, lua::ModInfo::StoreType::map);
+            save_if_changed(filepath, [&](putit::BinaryOArchive& ar) {
+                mod_serializer.save_mod_store_data(
+                    ar, lua::ModInfo::StoreType::map);
+            });
         }
     }
 
@@ -1201,7 +1277,7 @@ void fmode_1_2(bool read)
         {
             tmpload(u8"mod_cdata_"s + mid + u8".s2");
 
-            std::ifstream in{filepath.native(), std::ios::binary};
+            SaveIFStream in{filepath};
             putit::BinaryIArchive ar{in};
             std::tie(index_start, index_end) =
                 mod_serializer.load_handles<Character>(
@@ -1218,10 +1294,10 @@ void fmode_1_2(bool read)
             Save::instance().add(filepath.filename());
             writeloadedbuff(u8"mod_cdata_"s + mid + u8".s2");
 
-            std::ofstream out{filepath.native(), std::ios::binary};
-            putit::BinaryOArchive ar{out};
-            mod_serializer.save_handles<Character>(
-                ar, lua::ModInfo::StoreType::map);
+            save_if_changed(filepath, [&](putit::BinaryOArchive& ar) {
+                mod_serializer.save_handles<Character>(
+                    ar, lua::ModInfo::StoreType::map);
+            });
         }
     }
 }
@@ -1347,7 +1423,7 @@ void fmode_3_4(bool read, const fs::path& filename)
     {
         tmpload(mod_filename);
 
-        std::ifstream in{mod_filepath.native(), std::ios::binary};
+        SaveIFStream in{mod_filepath};
         putit::BinaryIArchive ar{in};
         std::tie(index_start, index_end) =
             mod_serializer.load_handles<Item>(ar, lua::ModInfo::StoreType::map);
@@ -1363,9 +1439,9 @@ void fmode_3_4(bool read, const fs::path& filename)
         Save::instance().add(mod_filepath.filename());
         tmpload(mod_filename);
 
-        std::ofstream out{mod_filepath.native(), std::ios::binary};
-        putit::BinaryOArchive ar{out};
-        mod_serializer.save_handles<Item>(ar, lua::ModInfo::StoreType::map);
+        save_if_changed(mod_filepath, [&](putit::BinaryOArchive& ar) {
+            mod_serializer.save_handles<Item>(ar, lua::ModInfo::StoreType::map);
+        });
     }
 }
 
@@ -1408,7 +1484,7 @@ void fmode_17()
     {
         const auto filepath = dir / (u8"sdata_"s + mid + u8".s2");
         tmpload(u8"sdata_"s + mid + u8".s2");
-        std::ifstream in{filepath.native(), std::ios::binary};
+        SaveIFStream in{filepath};
         putit::BinaryIArchive ar{in};
         for (int cc = ELONA_MAX_PARTY_CHARACTERS; cc < ELONA_MAX_CHARACTERS;
              ++cc)
@@ -1431,6 +1507,7 @@ void fmode_10()
     {
         fs::remove_all(entry.path());
     }
+    written_files.clear();
 }
 
 
@@ -1559,16 +1636,36 @@ void Save::save(const fs::path& save_dir)
     {
         const auto& filename = pair.first;
         const auto& is_saved = pair.second;
+        const auto destination = save_dir / filename;
         if (is_saved)
         {
+            const auto source = filesystem::dirs::tmp() / filename;
+            const auto written = written_files.find(source);
+            if (written == std::end(written_files))
+            {
+                fs::copy_file(
+                    source, destination, fs::copy_option::overwrite_if_exists);
+                copied_files.erase(destination);
+                continue;
+            }
+
+            // Skip the files that were not written since they were copied.
+            const auto copied = copied_files.find(destination);
+            if (copied != std::end(copied_files) &&
+                copied->second == written->second.write_number &&
+                fs::exists(destination) &&
+                fs::file_size(destination) == written->second.size)
+            {
+                continue;
+            }
             fs::copy_file(
-                filesystem::dirs::tmp() / filename,
-                save_dir / filename,
-                fs::copy_option::overwrite_if_exists);
+                source, destination, fs::copy_option::overwrite_if_exists);
+            copied_files[destination] = written->second.write_number;
         }
-        else if (fs::exists(save_dir / filename))
+        else if (fs::exists(destination))
         {
-            fs::remove_all(save_dir / filename);
+            fs::remove_all(destination);
+            copied_files.erase(destination);
         }
     }
 }
@@ -1585,6 +1682,11 @@ void ctrl_file(FileOperation file_operation)
         game_data.play_time + timeGetTime() / 1000 - time_begin;
     time_begin = timeGetTime() / 1000;
 
+    // Reading replaces characters and items in place.
+    equipped_enchantments.invalidate_all();
+    item_name_cache.clear();
+    food_expiration_schedule.invalidate();
+
     switch (file_operation)
     {
     case FileOperation::map_read:
@@ -1623,6 +1725,11 @@ void ctrl_file(FileOperation2 file_operation, const fs::path& filepath)
         game_data.play_time + timeGetTime() / 1000 - time_begin;
     time_begin = timeGetTime() / 1000;
 
+    // Reading replaces characters and items in place.
+    equipped_enchantments.invalidate_all();
+    item_name_cache.clear();
+    food_expiration_schedule.invalidate();
+
     switch (file_operation)
     {
     case FileOperation2::map_items_read:
@@ -1662,6 +1769,7 @@ void tmpload(const fs::path& filename)
             original_file,
             filesystem::dirs::tmp() / filename,
             fs::copy_option::overwrite_if_exists);
+        written_files.erase(filesystem::dirs::tmp() / filename);
     }
 }
 
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <unordered_map>
 #include "../util/noncopyable.hpp"
 #include "filesystem.hpp"
@@ -58,6 +59,10 @@ private:
     Save() = default;
 
     std::unordered_map<fs::path, bool> saved_files;
+
+    // The write of each file last copied to a save directory, numbered by
+    // save_if_changed().
+    std::unordered_map<fs::path, uint64_t> copied_files;
 };
 
 
@@ -940,7 +940,7 @@ label_2061_internal:
             break;
         }
         p = list(0, p);
-        s(0) = itemname(p, inv[p].number());
+        s(0) = item_name_cache.get(p, inv[p].number());
         s(1) = cnvweight(inv[p].weight * inv[p].number());
         if (invctrl == 11)
         {
@@ -18,24 +18,31 @@ void _initialize_iterable_dbs(lua::DataTable& data)
 {
     the_character_db.initialize(data);
     the_character_db.load_all();
+    the_character_db.freeze();
 
     the_item_db.initialize(data);
     the_item_db.load_all();
+    the_item_db.freeze();
 
     the_mapdef_db.initialize(data);
     the_mapdef_db.load_all();
+    the_mapdef_db.freeze();
 
     the_trait_db.initialize(data);
     the_trait_db.load_all();
+    the_trait_db.freeze();
 
     the_fish_db.initialize(data);
     the_fish_db.load_all();
+    the_fish_db.freeze();
 
     the_ability_db.initialize(data);
     the_ability_db.load_all();
+    the_ability_db.freeze();
 
     the_item_material_db.initialize(data);
     the_item_material_db.load_all();
+    the_item_material_db.freeze();
 
     the_race_db.initialize(data);
     the_race_db.load_all();
@@ -45,6 +52,7 @@ void _initialize_iterable_dbs(lua::DataTable& data)
 
     the_god_db.initialize(data);
     the_god_db.load_all();
+    the_god_db.freeze();
 }
 
 
@@ -81,6 +89,8 @@ void _initialize_chip_dbs(lua::DataTable& data)
         initialize_map_chips(the_map_chip_db);
     }
 
+    draw_save_chip_layout();
+
     {
         the_asset_db.initialize(data);
         the_asset_db.load_all();
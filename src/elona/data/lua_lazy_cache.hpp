@@ -269,10 +269,54 @@ public:
 
 
 
+    // Legacy IDs at or above this are never put in the frozen table.
+    static constexpr LegacyIdType max_frozen_legacy_id = 65536;
+
+
+
     void clear()
     {
         Super::clear();
         _by_legacy_id.clear();
+        _frozen.clear();
+    }
+
+
+
+    /**
+     * Builds a table indexed by legacy ID of the entries loaded so far, so
+     * that looking them up by legacy ID skips both hash maps. Call it after
+     * `load_all()`. Other legacy IDs, like those of entries a mod adds later,
+     * still go through the lazy path.
+     */
+    void freeze()
+    {
+        _frozen.clear();
+        for (auto& pair : Super::_storage)
+        {
+            const auto legacy_id = pair.second.legacy_id;
+            if (legacy_id < 0 || max_frozen_legacy_id <= legacy_id)
+                continue;
+
+            const auto index = static_cast<size_t>(legacy_id);
+            if (_frozen.size() <= index)
+            {
+                _frozen.resize(index + 1, nullptr);
+            }
+            if (_frozen[index])
+                continue;
+
+            // Several entries may share a legacy ID; take the one the lazy
+            // path resolves to.
+            if (const auto id = get_id_from_legacy(legacy_id))
+            {
+                const auto itr = Super::_storage.find(*id);
+                if (itr != std::end(Super::_storage))
+                {
+                    _frozen[index] = &itr->second;
+                }
+            }
+        }
     }
 
 
@@ -281,6 +325,9 @@ public:
     {
         static_assert(Traits::has_legacy_id, "DB does not support legacy ID.");
 
+        if (const auto data = find_frozen(legacy_id))
+            return data->id;
+
         const auto itr = _by_legacy_id.find(legacy_id);
         if (itr != std::end(_by_legacy_id))
             return itr->second;
@@ -294,6 +341,9 @@ public:
 
     optional_ref<DataType> operator[](const LegacyIdType& legacy_id)
     {
+        if (const auto data = find_frozen(legacy_id))
+            return *data;
+
         if (const auto id = get_id_from_legacy(legacy_id))
         {
             return (*this)[*id];
@@ -327,9 +377,22 @@ public:
 protected:
     LegacyMapType _by_legacy_id;
 
+    // Points into `_storage`, whose elements never move.
+    std::vector<DataType*> _frozen;
+
 
 
 private:
+    DataType* find_frozen(const LegacyIdType& legacy_id) const
+    {
+        if (legacy_id < 0 || _frozen.size() <= static_cast<size_t>(legacy_id))
+            return nullptr;
+
+        return _frozen[static_cast<size_t>(legacy_id)];
+    }
+
+
+
     optional<IdType> retrieve_legacy_id_from_lua(const LegacyIdType& legacy_id)
     {
         optional<std::string> it =
@@ -6,5 +6,6 @@ namespace elona
 namespace debug
 {
 bool voldemort = false;
+bool check_chara_refresh = false;
 } // namespace debug
 } // namespace elona
@@ -10,6 +10,10 @@ namespace debug
 
 
 extern bool voldemort;
+
+// Makes chara_refresh() check its cached equipment stats against a full
+// recomputation and throw on mismatch.
+extern bool check_chara_refresh;
 }
 
 
@@ -10,6 +10,7 @@
 #include "dmgheal.hpp"
 #include "draw.hpp"
 #include "enums.hpp"
+#include "flow_field.hpp"
 #include "i18n.hpp"
 #include "item.hpp"
 #include "itemgen.hpp"
@@ -21,6 +22,7 @@
 #include "quest.hpp"
 #include "random_event.hpp"
 #include "save.hpp"
+#include "save_stream.hpp"
 #include "ui.hpp"
 #include "variables.hpp"
 
@@ -525,6 +527,7 @@ void eh_ragnarok(const DeferredEvent& event)
             x = rnd(map_data.width);
             y = rnd(map_data.height);
             cell_data.at(x, y).chip_id_actual = 37;
+            flow_fields.notify_cell_changed(x, y);
         }
         x = rnd(inf_screenw) + scx;
         y = rnd(inf_screenh) + scy;
@@ -773,6 +776,7 @@ void eh_nuclear_bomb(const DeferredEvent& event)
                 if (rnd(4) || f == 1)
                 {
                     cell_data.at(dx, dy).chip_id_actual = 37;
+                    flow_fields.notify_cell_changed(dx, dy);
                 }
                 if (rnd(10) == 0 || f == 1)
                 {
@@ -1234,14 +1238,16 @@ TurnResult event_start_proc()
 
 void event_load(const fs::path& path)
 {
-    putit::BinaryIArchive::load(path, g_event_queue);
+    SaveIFStream in{path};
+    putit::BinaryIArchive::load(in, g_event_queue);
 }
 
 
 
 void event_save(const fs::path& path)
 {
-    putit::BinaryOArchive::save(path, g_event_queue);
+    SaveOFStream out{path};
+    putit::BinaryOArchive::save(out, g_event_queue);
 }
 
 } // namespace elona
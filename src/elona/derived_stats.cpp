@@ -0,0 +1,438 @@
+#include "derived_stats.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include "ability.hpp"
+#include "character.hpp"
+#include "variables.hpp"
+
+
+
+namespace elona
+{
+
+EquipmentContributionCache equipment_contribution_cache;
+EquippedEnchantments equipped_enchantments;
+
+
+
+void EquipmentContribution::compute(const Item& item, bool is_in_hand)
+{
+    // Keep the storage of the vectors; this runs on every equipment change.
+    auto skills = std::move(skill_bonuses);
+    auto flags = std::move(flag_enchantments);
+    *this = {};
+    skill_bonuses = std::move(skills);
+    skill_bonuses.clear();
+    flag_enchantments = std::move(flags);
+    flag_enchantments.clear();
+
+    weight = item.weight;
+    is_shield = item.skill == 168;
+    dv = item.dv;
+    pv = item.pv;
+    if (item.dice_x == 0)
+    {
+        hit_bonus = item.hit_bonus;
+        damage_bonus = item.damage_bonus;
+        pv += item.enhancement * 2 +
+            (item.curse_state == CurseState::blessed) * 2;
+    }
+    else if (is_in_hand)
+    {
+        is_attack_weapon = true;
+    }
+    if (item.curse_state == CurseState::cursed)
+    {
+        curse_power += 20;
+    }
+    if (item.curse_state == CurseState::doomed)
+    {
+        curse_power += 100;
+    }
+    if (item.material == 8)
+    {
+        ether_disease_speed += 5;
+    }
+
+    for (size_t i = 0; i < 15 && i < item.enchantments.size(); ++i)
+    {
+        const auto id = item.enchantments[i].id;
+        const auto power = item.enchantments[i].power;
+        if (id == 0)
+        {
+            break;
+        }
+        if (id >= 10000)
+        {
+            const auto skill = id % 10000;
+            switch (id / 10000)
+            {
+            case 1:
+                skill_bonuses.push_back(
+                    {skill, power / 50 + 1, SkillOp::add});
+                break;
+            case 2:
+                skill_bonuses.push_back(
+                    {skill, power / 2, SkillOp::add_and_fix_negative});
+                break;
+            case 3:
+                skill_bonuses.push_back(
+                    {skill, power / 50 + 1, SkillOp::add_if_learned});
+                break;
+            default: break;
+            }
+            continue;
+        }
+        switch (id)
+        {
+        case 56: catches_god_signal = true; break;
+        case 59: reveals_religion = true; break;
+        case 29:
+            skill_bonuses.push_back({18, power / 50 + 1, SkillOp::add});
+            seven_league_boot_effect += power / 8;
+            break;
+        case 21:
+        case 23:
+        case 24:
+        case 25:
+        case 26:
+        case 27:
+        case 28:
+        case 32:
+        case 35:
+        case 41:
+        case 42:
+        case 45:
+        case 46:
+        case 47:
+        case 55: flag_enchantments.push_back(id); break;
+        case 52: decrease_physical_damage += power / 40 + 5; break;
+        case 53: nullify_damage += power / 60 + 3; break;
+        case 54: cut_counterattack += power / 5; break;
+        case 44: rate_of_critical_hit += power / 50; break;
+        case 39: rate_to_pierce += power / 50; break;
+        case 50: extra_attack += power / 15; break;
+        case 51: grants_extra_shot = true; break;
+        case 30: protects_from_etherwind = true; break;
+        case 31: protects_from_bad_weather = true; break;
+        default: break;
+        }
+    }
+}
+
+
+
+void EquipmentContribution::apply_to(Character& chara) const
+{
+    const auto cc = chara.index;
+
+    chara.sum_of_equipment_weight += weight;
+    if (is_shield && !(chara.equipment_type & 1))
+    {
+        chara.equipment_type += 1;
+    }
+    chara.dv += dv;
+    chara.pv += pv;
+    chara.hit_bonus += hit_bonus;
+    chara.damage_bonus += damage_bonus;
+    chara.curse_power += curse_power;
+    chara.rate_to_pierce += rate_to_pierce;
+    chara.rate_of_critical_hit += rate_of_critical_hit;
+    chara.extra_attack += extra_attack;
+    if (grants_extra_shot)
+    {
+        // Extra shot enchantments have always overwritten the sum.
+        chara.extra_shot = 100;
+    }
+    chara.decrease_physical_damage += decrease_physical_damage;
+    chara.nullify_damage += nullify_damage;
+    chara.cut_counterattack += cut_counterattack;
+
+    for (const auto& bonus : skill_bonuses)
+    {
+        switch (bonus.op)
+        {
+        case SkillOp::add: sdata(bonus.id, cc) += bonus.amount; break;
+        case SkillOp::add_and_fix_negative:
+            sdata(bonus.id, cc) += bonus.amount;
+            if (sdata(bonus.id, cc) < 0)
+            {
+                sdata(bonus.id, cc) = 1;
+            }
+            break;
+        case SkillOp::add_if_learned:
+            if (sdata.get(bonus.id, cc).original_level != 0)
+            {
+                sdata(bonus.id, cc) += bonus.amount;
+                if (sdata(bonus.id, cc) < 1)
+                {
+                    sdata(bonus.id, cc) = 1;
+                }
+            }
+            break;
+        }
+    }
+
+    for (const auto& id : flag_enchantments)
+    {
+        switch (id)
+        {
+        case 32: chara.is_floating() = true; break;
+        case 35: chara.can_see_invisible() = true; break;
+        case 23: chara.is_immune_to_blindness() = true; break;
+        case 24: chara.is_immune_to_paralyzation() = true; break;
+        case 25: chara.is_immune_to_confusion() = true; break;
+        case 26: chara.is_immune_to_fear() = true; break;
+        case 27: chara.is_immune_to_sleep() = true; break;
+        case 28: chara.is_immune_to_poison() = true; break;
+        case 42: chara.can_digest_rotten_food() = true; break;
+        case 41: chara.is_protected_from_thieves() = true; break;
+        case 55: chara.cures_bleeding_quickly() = true; break;
+        default: chara.has_cursed_equipments() = true; break;
+        }
+    }
+
+    if (cc == 0)
+    {
+        game_data.ether_disease_speed += ether_disease_speed;
+        game_data.seven_league_boot_effect += seven_league_boot_effect;
+        if (catches_god_signal)
+        {
+            game_data.catches_god_signal = 1;
+        }
+        if (reveals_religion)
+        {
+            game_data.reveals_religion = 1;
+        }
+        if (protects_from_etherwind)
+        {
+            game_data.protects_from_etherwind = 1;
+        }
+        if (protects_from_bad_weather)
+        {
+            game_data.protects_from_bad_weather = 1;
+        }
+    }
+}
+
+
+
+void EquipmentContributionCache::Key::assign(const Item& item, bool in_hand)
+{
+    item_index = item.index;
+    is_in_hand = in_hand;
+    weight = item.weight;
+    skill = item.skill;
+    dv = item.dv;
+    pv = item.pv;
+    dice_x = item.dice_x;
+    hit_bonus = item.hit_bonus;
+    damage_bonus = item.damage_bonus;
+    enhancement = item.enhancement;
+    material = item.material;
+    curse_state = item.curse_state;
+    enchantment_count = 0;
+    for (size_t i = 0; i < enchantments.size() && i < item.enchantments.size();
+         ++i)
+    {
+        if (item.enchantments[i].id == 0)
+        {
+            break;
+        }
+        enchantments[i] = item.enchantments[i];
+        ++enchantment_count;
+    }
+}
+
+
+
+bool EquipmentContributionCache::Key::matches(const Item& item, bool in_hand)
+    const
+{
+    if (item_index != item.index || is_in_hand != in_hand ||
+        weight != item.weight || skill != item.skill || dv != item.dv ||
+        pv != item.pv || dice_x != item.dice_x ||
+        hit_bonus != item.hit_bonus || damage_bonus != item.damage_bonus ||
+        enhancement != item.enhancement || material != item.material ||
+        curse_state != item.curse_state)
+    {
+        return false;
+    }
+    for (size_t i = 0; i < enchantments.size(); ++i)
+    {
+        const auto& enchantment = i < item.enchantments.size()
+            ? item.enchantments[i]
+            : Enchantment{};
+        if (i == enchantment_count)
+        {
+            return enchantment.id == 0;
+        }
+        if (!(enchantments[i] == enchantment))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+
+const EquipmentContribution& EquipmentContributionCache::get(
+    int chara_index,
+    int body_part_index,
+    const Item& item,
+    bool is_in_hand)
+{
+    if (_entries.empty())
+    {
+        _entries.resize(ELONA_MAX_CHARACTERS);
+    }
+
+    auto& entry = _entries.at(static_cast<size_t>(chara_index))
+                      .at(static_cast<size_t>(body_part_index));
+    if (!entry.valid || !entry.key.matches(item, is_in_hand))
+    {
+        entry.key.assign(item, is_in_hand);
+        entry.contribution.compute(item, is_in_hand);
+        entry.valid = true;
+    }
+    return entry.contribution;
+}
+
+
+
+void EnchantmentTable::Powers::add(int power)
+{
+    if (!found || max < power)
+    {
+        max = power;
+    }
+    found = true;
+}
+
+
+
+void EnchantmentTable::build(const Character& chara)
+{
+    _plain.fill({});
+    _compound.clear();
+
+    for (const auto& body_part : chara.body_parts)
+    {
+        if (body_part % 10000 == 0)
+        {
+            continue;
+        }
+        const auto& enchantments = inv[body_part % 10000 - 1].enchantments;
+        for (size_t i = 0; i < enchantments.size(); ++i)
+        {
+            const auto id = enchantments[i].id;
+            if (id == 0)
+            {
+                break;
+            }
+            const auto end =
+                enchantments.begin() + static_cast<std::ptrdiff_t>(i);
+            const auto is_duplicate =
+                std::any_of(enchantments.begin(), end, [&](const auto& enc) {
+                    return enc.id == id;
+                });
+            if (is_duplicate)
+            {
+                continue;
+            }
+
+            const auto power = enchantments[i].power;
+            if (0 <= id && id < plain_id_count)
+            {
+                _plain[static_cast<size_t>(id)].add(power);
+                continue;
+            }
+            auto it = std::lower_bound(
+                _compound.begin(),
+                _compound.end(),
+                id,
+                [](const auto& entry, int value) {
+                    return entry.first < value;
+                });
+            if (it == _compound.end() || it->first != id)
+            {
+                it = _compound.insert(it, std::make_pair(id, Powers{}));
+            }
+            it->second.add(power);
+        }
+    }
+}
+
+
+
+const EnchantmentTable::Powers* EnchantmentTable::_find(int id) const
+{
+    if (0 <= id && id < plain_id_count)
+    {
+        return &_plain[static_cast<size_t>(id)];
+    }
+    const auto it = std::lower_bound(
+        _compound.begin(),
+        _compound.end(),
+        id,
+        [](const auto& entry, int value) { return entry.first < value; });
+    if (it == _compound.end() || it->first != id)
+    {
+        return nullptr;
+    }
+    return &it->second;
+}
+
+
+
+optional<int> EnchantmentTable::max(int id) const
+{
+    const auto powers = _find(id);
+    if (!powers || !powers->found)
+    {
+        return none;
+    }
+    return powers->max;
+}
+
+
+
+const EnchantmentTable& EquippedEnchantments::get(const Character& chara)
+{
+    if (_entries.empty())
+    {
+        _entries.resize(ELONA_MAX_CHARACTERS);
+    }
+
+    auto& entry = _entries.at(static_cast<size_t>(chara.index));
+    if (!entry.valid || entry.generation != _generation ||
+        entry.body_parts != chara.body_parts)
+    {
+        entry.table.build(chara);
+        entry.body_parts = chara.body_parts;
+        entry.generation = _generation;
+        entry.valid = true;
+    }
+    return entry.table;
+}
+
+
+
+void EquippedEnchantments::invalidate(int chara_index)
+{
+    if (static_cast<size_t>(chara_index) < _entries.size())
+    {
+        _entries[static_cast<size_t>(chara_index)].valid = false;
+    }
+}
+
+
+
+void EquippedEnchantments::invalidate_all()
+{
+    ++_generation;
+}
+
+} // namespace elona
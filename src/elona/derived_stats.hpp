@@ -0,0 +1,206 @@
+#pragma once
+
+#include <array>
+#include <utility>
+#include <vector>
+#include "item.hpp"
+#include "optional.hpp"
+
+
+
+namespace elona
+{
+
+struct Character;
+
+
+
+/**
+ * Derived stats granted by one equipped item. They depend only on the item
+ * and on whether it is held in a hand slot, not on the wearer, so
+ * `chara_refresh()` can cache them per body part and decode an item's
+ * enchantments again only after the item has changed.
+ */
+struct EquipmentContribution
+{
+    enum class SkillOp
+    {
+        add,
+        add_and_fix_negative, // Resets the level to 1 if it goes below 0.
+        add_if_learned, // Ditto for levels below 1; skipped if unlearned.
+    };
+
+    struct SkillBonus
+    {
+        int id;
+        int amount;
+        SkillOp op;
+    };
+
+
+    int weight = 0;
+    bool is_shield = false;
+    bool is_attack_weapon = false;
+    int dv = 0;
+    int pv = 0;
+    int hit_bonus = 0;
+    int damage_bonus = 0;
+    int curse_power = 0;
+    int rate_to_pierce = 0;
+    int rate_of_critical_hit = 0;
+    int extra_attack = 0;
+    bool grants_extra_shot = false;
+    int decrease_physical_damage = 0;
+    int nullify_damage = 0;
+    int cut_counterattack = 0;
+
+    // Applied in order since each clamps the running skill level.
+    std::vector<SkillBonus> skill_bonuses;
+
+    // IDs of enchantments which set a character flag.
+    std::vector<int> flag_enchantments;
+
+    // Effects only the player receives.
+    int ether_disease_speed = 0;
+    int seven_league_boot_effect = 0;
+    bool catches_god_signal = false;
+    bool reveals_religion = false;
+    bool protects_from_etherwind = false;
+    bool protects_from_bad_weather = false;
+
+
+    void compute(const Item& item, bool is_in_hand);
+
+    /**
+     * Adds the contribution to @a chara. `attacknum` is left to the caller.
+     */
+    void apply_to(Character& chara) const;
+};
+
+
+
+/**
+ * Per-character, per-body-part cache of `EquipmentContribution`. An entry is
+ * reused as long as every item field it was computed from is unchanged, so
+ * equipping, enchanting or cursing an item is picked up without any explicit
+ * invalidation.
+ */
+class EquipmentContributionCache
+{
+public:
+    static constexpr size_t body_part_count = 30;
+
+
+    const EquipmentContribution& get(
+        int chara_index,
+        int body_part_index,
+        const Item& item,
+        bool is_in_hand);
+
+
+private:
+    struct Key
+    {
+        int item_index = -1;
+        bool is_in_hand = false;
+        int weight = 0;
+        int skill = 0;
+        int dv = 0;
+        int pv = 0;
+        int dice_x = 0;
+        int hit_bonus = 0;
+        int damage_bonus = 0;
+        int enhancement = 0;
+        int material = 0;
+        CurseState curse_state = CurseState::none;
+        size_t enchantment_count = 0;
+        std::array<Enchantment, 15> enchantments;
+
+        void assign(const Item& item, bool is_in_hand);
+        bool matches(const Item& item, bool is_in_hand) const;
+    };
+
+    struct Entry
+    {
+        bool valid = false;
+        Key key;
+        EquipmentContribution contribution;
+    };
+
+    std::vector<std::array<Entry, body_part_count>> _entries;
+};
+
+
+
+extern EquipmentContributionCache equipment_contribution_cache;
+
+
+
+/**
+ * The strongest power of each enchantment on a character's equipment. Each
+ * item counts once per enchantment ID, with the power of its first
+ * enchantment of that ID, as `enchantment_find(const Item&, int)` reports it.
+ */
+class EnchantmentTable
+{
+public:
+    void build(const Character& chara);
+
+    optional<int> max(int id) const;
+
+
+private:
+    // Plain enchantment IDs are small; compound ones (skill bonuses,
+    // resistances, sustained attributes, ...) are `kind * 10000 + parameter`
+    // and only a few of them are on any character at once.
+    static constexpr int plain_id_count = 100;
+
+    struct Powers
+    {
+        bool found = false;
+        int max = 0;
+
+        void add(int power);
+    };
+
+    const Powers* _find(int id) const;
+
+    std::array<Powers, plain_id_count> _plain;
+    std::vector<std::pair<int, Powers>> _compound; // Sorted by ID.
+};
+
+
+
+/**
+ * `EnchantmentTable` of every character, rebuilt on demand. A table is
+ * rebuilt when the character's body parts point to other items than when it
+ * was built, when the character is refreshed, or after an equipped item has
+ * gained or lost an enchantment.
+ */
+class EquippedEnchantments
+{
+public:
+    const EnchantmentTable& get(const Character& chara);
+
+    void invalidate(int chara_index);
+    void invalidate_all();
+
+
+private:
+    struct Entry
+    {
+        bool valid = false;
+        int generation = 0;
+        std::vector<int> body_parts;
+        EnchantmentTable table;
+    };
+
+    std::vector<Entry> _entries;
+    int _generation = 0;
+};
+
+
+
+extern EquippedEnchantments equipped_enchantments;
+
+} // namespace elona
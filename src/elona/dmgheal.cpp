@@ -657,15 +657,14 @@ int damage_hp(
             {
                 if (g_config.heartbeat())
                 {
-                    int threshold =
-                        config_get_integer("core.screen.heartbeat_threshold");
+                    int threshold = g_config.heartbeat_threshold();
                     if (victim.hp < victim.max_hp * (threshold * 0.01))
                     {
                         if (!CHECKPLAY(32))
                         {
                             snd("core.Heart1");
 
-                            if (config_get_boolean("core.android.vibrate"))
+                            if (g_config.vibrate())
                             {
                                 snail::android::vibrate_pulse();
                             }
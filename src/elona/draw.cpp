@@ -1,6 +1,10 @@
 #include "draw.hpp"
+#include <algorithm>
 #include <cmath>
+#include <unordered_map>
 #include "../snail/application.hpp"
+#include "../snail/hsp.hpp"
+#include "../snail/image.hpp"
 #include "character.hpp"
 #include "config.hpp"
 #include "data/types/type_asset.hpp"
@@ -136,19 +140,50 @@ void _set_pcc_depending_on_equipments(Character& chara, const Item& equipment)
 
 
 
+int _pcc_texture_id(int chara_index)
+{
+    return 10 + PicLoader::max_buffers + TintedBuffers::max_buffers +
+        chara_index;
+}
+
+
+
+// Part images are loaded when first needed and kept for every character
+// wearing the same part. none if the part has no image.
+std::unordered_map<std::string, optional<snail::Image>> pcc_part_images;
+
+optional<snail::Image>& _pcc_part_image(const std::string& filename)
+{
+    const auto itr = pcc_part_images.find(filename);
+    if (itr != pcc_part_images.end())
+    {
+        return itr->second;
+    }
+
+    auto& image = pcc_part_images[filename];
+    const auto filepath = filesystem::dirs::graphic() / filename;
+    if (fs::exists(filepath))
+    {
+        // The same key color as picload() uses for PCC images.
+        image.emplace(filepath, snail::Color{43, 133, 133});
+    }
+    return image;
+}
+
+
+
 void _load_pcc_part(Character& chara, int body_part, const char* body_part_str)
 {
     const auto idx = chara.index;
 
-    const auto filepath = filesystem::dirs::graphic() /
-        (u8"pcc_"s + body_part_str + (pcc(body_part, idx) % 1000) + u8".bmp");
-    if (!fs::exists(filepath))
+    auto& image = _pcc_part_image(
+        u8"pcc_"s + body_part_str + (pcc(body_part, idx) % 1000) + u8".bmp");
+    if (!image)
         return;
 
-    const auto texture_id =
-        10 + PicLoader::max_buffers + TintedBuffers::max_buffers + idx;
+    const auto texture_id = _pcc_texture_id(idx);
 
-    picload(filepath, 128, 0, false);
+    snail::hsp::picload(*image, 128, 0, false);
     boxf(256, 0, 128, 198);
     gmode(2);
     pget(128, 0);
@@ -163,6 +198,112 @@ void _load_pcc_part(Character& chara, int body_part, const char* body_part_str)
     set_color_mod(255, 255, 255, texture_id);
 }
 
+
+
+// Draws all layers of the character's looks to the selected buffer.
+void _compose_pcc(Character& chara, bool with_equipments)
+{
+    const auto idx = chara.index;
+
+    if (with_equipments)
+    {
+        if (pcc(24, idx) == 0)
+        {
+            _load_pcc_part(chara, 4, u8"mantle_");
+        }
+    }
+    _load_pcc_part(chara, 1, u8"hairbk_");
+    if (idx == 0 && game_data.mount != 0 && pcc(16, idx) != 0)
+    {
+        _load_pcc_part(chara, 16, u8"ridebk_");
+    }
+    else
+    {
+        _load_pcc_part(chara, 15, u8"body_");
+    }
+    _load_pcc_part(chara, 14, u8"eye_");
+    if (idx != 0 || game_data.mount == 0 || pcc(16, idx) == 0)
+    {
+        _load_pcc_part(chara, 7, u8"pants_");
+    }
+    _load_pcc_part(chara, 9, u8"cloth_");
+    if (with_equipments)
+    {
+        if (pcc(20, idx) == 0)
+        {
+            _load_pcc_part(chara, 2, u8"chest_");
+        }
+        if ((idx != 0 || game_data.mount == 0 || pcc(16, idx) == 0) &&
+            pcc(21, idx) == 0)
+        {
+            _load_pcc_part(chara, 3, u8"leg_");
+        }
+        if (pcc(22, idx) == 0)
+        {
+            _load_pcc_part(chara, 5, u8"belt_");
+        }
+        if (pcc(23, idx) == 0)
+        {
+            _load_pcc_part(chara, 8, u8"glove_");
+        }
+    }
+    if (idx == 0)
+    {
+        if (game_data.mount != 0)
+        {
+            _load_pcc_part(chara, 16, u8"ride_");
+        }
+    }
+    if (with_equipments)
+    {
+        if (pcc(24, idx) == 0)
+        {
+            _load_pcc_part(chara, 4, u8"mantlebk_");
+        }
+    }
+    _load_pcc_part(chara, 1, u8"hair_");
+    _load_pcc_part(chara, 10, u8"subhair_");
+    _load_pcc_part(chara, 11, u8"etc_");
+    _load_pcc_part(chara, 12, u8"etc_");
+    _load_pcc_part(chara, 13, u8"etc_");
+}
+
+
+
+// The looks each character's PCC buffer was composed with, by character
+// index.
+std::unordered_map<int, std::vector<int>> pcc_composites;
+
+// Everything create_pcpic() composes from: all PCC parameters, which include
+// the parts from equipments, and whether the player is riding.
+std::vector<int> _pcc_composite_key(
+    const Character& chara,
+    bool with_equipments)
+{
+    const auto idx = chara.index;
+
+    std::vector<int> key;
+    // The range saved with the other character data.
+    for (int i = 0; i < 30; ++i)
+    {
+        key.push_back(pcc(i, idx));
+    }
+    key.push_back(with_equipments ? 1 : 0);
+    key.push_back(idx == 0 ? game_data.mount : 0);
+    return key;
+}
+
+
+
+// The part images hold textures, which must be freed before the renderer, and
+// so cannot wait for the destruction of the statics. The composites describe
+// what the PCC buffers hold, which is lost if the renderer resets them.
+void _clear_pcc_caches()
+{
+    pcc_part_images.clear();
+    pcc_composites.clear();
+}
+
 } // namespace
 
 
@@ -626,12 +767,6 @@ void create_pcpic(Character& chara, bool with_equipments)
 {
     const auto idx = chara.index;
 
-    buffer(
-        10 + PicLoader::max_buffers + TintedBuffers::max_buffers + idx,
-        384,
-        198);
-    boxf();
-
     if (pcc(15, idx) == 0)
     {
         pcc(15, idx) = chara.sex + 1;
@@ -662,67 +797,36 @@ void create_pcpic(Character& chara, bool with_equipments)
 
     pcc(10, idx) = pcc(1, idx) / 1000 * 1000 + pcc(10, idx) % 1000;
     pcc(14, idx) = pcc(15, idx) / 1000 * 1000 + pcc(14, idx) % 1000;
-    if (with_equipments)
+
+    // Composing loads and tints every layer, so it is skipped if the
+    // character already looks the same, and copied from another character
+    // who looks the same.
+    auto key = _pcc_composite_key(chara, with_equipments);
+    if (pcc_composites[idx] == key)
     {
-        if (pcc(24, idx) == 0)
-        {
-            _load_pcc_part(chara, 4, u8"mantle_");
-        }
+        gsel(0);
+        return;
     }
-    _load_pcc_part(chara, 1, u8"hairbk_");
-    if (idx == 0 && game_data.mount != 0 && pcc(16, idx) != 0)
+
+    buffer(_pcc_texture_id(idx), 384, 198);
+    boxf();
+    const auto same = std::find_if(
+        std::begin(pcc_composites),
+        std::end(pcc_composites),
+        [&](const auto& pair) {
+            return pair.first != idx && pair.second == key;
+        });
+    if (same != std::end(pcc_composites))
     {
-        _load_pcc_part(chara, 16, u8"ridebk_");
+        gmode(0);
+        gcopy(_pcc_texture_id(same->first), 0, 0, 384, 198, 0, 0);
+        gmode(2);
     }
     else
     {
-        _load_pcc_part(chara, 15, u8"body_");
-    }
-    _load_pcc_part(chara, 14, u8"eye_");
-    if (idx != 0 || game_data.mount == 0 || pcc(16, idx) == 0)
-    {
-        _load_pcc_part(chara, 7, u8"pants_");
+        _compose_pcc(chara, with_equipments);
     }
-    _load_pcc_part(chara, 9, u8"cloth_");
-    if (with_equipments)
-    {
-        if (pcc(20, idx) == 0)
-        {
-            _load_pcc_part(chara, 2, u8"chest_");
-        }
-        if ((idx != 0 || game_data.mount == 0 || pcc(16, idx) == 0) &&
-            pcc(21, idx) == 0)
-        {
-            _load_pcc_part(chara, 3, u8"leg_");
-        }
-        if (pcc(22, idx) == 0)
-        {
-            _load_pcc_part(chara, 5, u8"belt_");
-        }
-        if (pcc(23, idx) == 0)
-        {
-            _load_pcc_part(chara, 8, u8"glove_");
-        }
-    }
-    if (idx == 0)
-    {
-        if (game_data.mount != 0)
-        {
-            _load_pcc_part(chara, 16, u8"ride_");
-        }
-    }
-    if (with_equipments)
-    {
-        if (pcc(24, idx) == 0)
-        {
-            _load_pcc_part(chara, 4, u8"mantlebk_");
-        }
-    }
-    _load_pcc_part(chara, 1, u8"hair_");
-    _load_pcc_part(chara, 10, u8"subhair_");
-    _load_pcc_part(chara, 11, u8"etc_");
-    _load_pcc_part(chara, 12, u8"etc_");
-    _load_pcc_part(chara, 13, u8"etc_");
+    pcc_composites[idx] = std::move(key);
 
     gsel(0);
 }
@@ -745,6 +849,7 @@ void initialize_map_chips(const MapChipDB& db)
     {
         for (int i = 0; i < ChipData::atlas_count; i++)
         {
+            std::vector<PicLoader::LoadRequest> requests;
             PicLoader::MapType extents_chips;
             PicLoader::MapType extents_feats;
 
@@ -760,7 +865,7 @@ void initialize_map_chips(const MapChipDB& db)
                 if (chip.filepath)
                 {
                     // chip is from an external file.
-                    loader.load(*chip.filepath, chip.key, type);
+                    requests.push_back({*chip.filepath, chip.key, type});
                 }
                 else
                 {
@@ -776,15 +881,16 @@ void initialize_map_chips(const MapChipDB& db)
                 }
             }
 
-            loader.add_predefined_extents(
-                filesystem::dirs::graphic() / (u8"map"s + i + ".bmp"),
-                extents_chips,
-                PicLoader::PageType::map_chip);
+            loader.load(requests);
 
-            loader.add_predefined_extents(
+            // Chips and feats share the atlas; decode it only once.
+            snail::Image atlas{
                 filesystem::dirs::graphic() / (u8"map"s + i + ".bmp"),
-                extents_feats,
-                PicLoader::PageType::map_feat);
+                snail::Color{0, 0, 0}};
+            loader.add_predefined_extents(
+                atlas, extents_chips, PicLoader::PageType::map_chip);
+            loader.add_predefined_extents(
+                atlas, extents_feats, PicLoader::PageType::map_feat);
         }
     }
     for (const auto& buffer :
@@ -893,6 +999,7 @@ void draw_prepare_map_chips()
 
 void initialize_item_chips(const ItemChipDB& db)
 {
+    std::vector<PicLoader::LoadRequest> requests;
     PicLoader::MapType predefined_extents;
 
     for (const auto& chip_data : db.values())
@@ -910,7 +1017,8 @@ void initialize_item_chips(const ItemChipDB& db)
         if (chip_data.filepath)
         {
             // chip is from an external file.
-            loader.load(*chip_data.filepath, key, PicLoader::PageType::item);
+            requests.push_back(
+                {*chip_data.filepath, key, PicLoader::PageType::item});
         }
         else
         {
@@ -919,6 +1027,7 @@ void initialize_item_chips(const ItemChipDB& db)
         }
     }
 
+    loader.load(requests);
     loader.add_predefined_extents(
         filesystem::dirs::graphic() / u8"item.bmp",
         predefined_extents,
@@ -929,6 +1038,7 @@ void initialize_item_chips(const ItemChipDB& db)
 
 void initialize_portraits(const PortraitDB& db)
 {
+    std::vector<PicLoader::LoadRequest> requests;
     PicLoader::MapType predefined_extents;
 
     for (const auto& portrait_data : db.values())
@@ -938,8 +1048,8 @@ void initialize_portraits(const PortraitDB& db)
         if (portrait_data.filepath)
         {
             // Portrait is from an external file.
-            loader.load(
-                *portrait_data.filepath, key, PicLoader::PageType::portrait);
+            requests.push_back(
+                {*portrait_data.filepath, key, PicLoader::PageType::portrait});
         }
         else
         {
@@ -948,6 +1058,7 @@ void initialize_portraits(const PortraitDB& db)
         }
     }
 
+    loader.load(requests);
     loader.add_predefined_extents(
         filesystem::dirs::graphic() / u8"face1.bmp",
         predefined_extents,
@@ -958,6 +1069,7 @@ void initialize_portraits(const PortraitDB& db)
 
 void initialize_chara_chips(const CharaChipDB& db)
 {
+    std::vector<PicLoader::LoadRequest> requests;
     PicLoader::MapType predefined_extents;
 
     for (const auto& chip_data : db.values())
@@ -975,8 +1087,8 @@ void initialize_chara_chips(const CharaChipDB& db)
         if (chip_data.filepath)
         {
             // Chip is from an external file.
-            loader.load(
-                *chip_data.filepath, key, PicLoader::PageType::character);
+            requests.push_back(
+                {*chip_data.filepath, key, PicLoader::PageType::character});
         }
         else
         {
@@ -985,6 +1097,7 @@ void initialize_chara_chips(const CharaChipDB& db)
         }
     }
 
+    loader.load(requests);
     loader.add_predefined_extents(
         filesystem::dirs::graphic() / u8"character.bmp",
         predefined_extents,
@@ -992,9 +1105,25 @@ void initialize_chara_chips(const CharaChipDB& db)
 }
 
 
+// The layout of the packed sprites, reused on the next launch.
+static fs::path _chip_layout_file()
+{
+    return filesystem::dirs::current_profile() / u8"chip_layout.txt";
+}
+
+
 void draw_clear_loaded_chips()
 {
     loader.clear();
+    loader.restore_layout(_chip_layout_file());
+    // The PCC parts may have been replaced, too.
+    _clear_pcc_caches();
+}
+
+
+void draw_save_chip_layout()
+{
+    loader.save_layout(_chip_layout_file());
 }
 
 
@@ -1002,6 +1131,10 @@ void initialize_all_chips()
 {
     initialize_mef();
     draw_prepare_map_chips();
+
+    snail::Application::instance().register_finalizer(_clear_pcc_caches);
+    snail::Application::instance().register_render_targets_reset_handler(
+        []() { pcc_composites.clear(); });
 }
 
 
@@ -88,6 +88,7 @@ void initialize_all_chips();
 void draw_prepare_map_chips();
 
 void draw_clear_loaded_chips();
+void draw_save_chip_layout();
 void draw_init_key_select_buffer();
 void draw_select_key(const std::string& key, int x, int y);
 
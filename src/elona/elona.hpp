@@ -12,6 +12,7 @@
 #include <stdexcept>
 #include <string>
 #include <unordered_map>
+#include <utility>
 #include "../snail/color.hpp"
 #include "../snail/font.hpp"
 #include "../snail/input.hpp"
@@ -454,6 +455,8 @@ int ginfo(int type);
 
 void gmode(int mode, int alpha = 255);
 
+std::pair<int, int> current_gmode();
+
 
 
 void grotate(
@@ -1,3 +1,5 @@
+#include <algorithm>
+#include <vector>
 #include "../util/fileutil.hpp"
 #include "../util/strutil.hpp"
 #include "../version.hpp"
@@ -31,6 +33,7 @@
 #include "enchantment.hpp"
 #include "equipment.hpp"
 #include "filesystem.hpp"
+#include "flow_field.hpp"
 #include "food.hpp"
 #include "fov.hpp"
 #include "i18n.hpp"
@@ -5616,32 +5619,56 @@ TurnResult try_interact_with_npc()
 
 
 
+namespace
+{
+
+// A row of the global `list` (and `listn`) arrays, as the sort functions below
+// see it.
+struct ListRow
+{
+    int value; // list(0, i)
+    int sort_key; // list(1, i)
+    std::string name; // listn(0, i)
+    std::string name2; // listn(1, i)
+};
+
+
+
+// Stable, so rows with equal keys keep their order, as they did when these
+// were bubble sorts.
+void sort_list_rows(std::vector<ListRow>& rows)
+{
+    std::stable_sort(
+        std::begin(rows),
+        std::end(rows),
+        [](const ListRow& a, const ListRow& b) {
+            return a.sort_key < b.sort_key;
+        });
+}
+
+} // namespace
+
+
+
 void sort_list_by_column1()
 {
     if (listmax < 1)
     {
         return;
     }
-    while (1)
+
+    std::vector<ListRow> rows;
+    rows.reserve(static_cast<size_t>(listmax));
+    for (int cnt = 0; cnt < listmax; ++cnt)
     {
-        p = 0;
-        for (int cnt = 0, cnt_end = (listmax - 1); cnt < cnt_end; ++cnt)
-        {
-            if (list(1, cnt) > list(1, cnt + 1))
-            {
-                p(0) = list(0, cnt);
-                p(1) = list(1, cnt);
-                list(0, cnt) = list(0, cnt + 1);
-                list(1, cnt) = list(1, cnt + 1);
-                list(0, cnt + 1) = p;
-                list(1, cnt + 1) = p(1);
-                p = 1;
-            }
-        }
-        if (p == 0)
-        {
-            break;
-        }
+        rows.push_back({list(0, cnt), list(1, cnt), "", ""});
+    }
+    sort_list_rows(rows);
+    for (int cnt = 0; cnt < listmax; ++cnt)
+    {
+        const auto& row = rows[static_cast<size_t>(cnt)];
+        list(0, cnt) = row.value;
+        list(1, cnt) = row.sort_key;
     }
 }
 
@@ -5653,32 +5680,24 @@ void sort_list_and_listn_by_column1()
     {
         return;
     }
-    while (1)
+
+    std::vector<ListRow> rows;
+    rows.reserve(static_cast<size_t>(listmax));
+    for (int cnt = 0; cnt < listmax; ++cnt)
     {
-        p = 0;
-        for (int cnt = 0, cnt_end = (listmax - 1); cnt < cnt_end; ++cnt)
-        {
-            if (list(1, cnt) > list(1, cnt + 1))
-            {
-                p(0) = list(0, cnt);
-                p(1) = list(1, cnt);
-                list(0, cnt) = list(0, cnt + 1);
-                list(1, cnt) = list(1, cnt + 1);
-                list(0, cnt + 1) = p;
-                list(1, cnt + 1) = p(1);
-                s(0) = listn(0, cnt);
-                s(1) = listn(1, cnt);
-                listn(0, cnt) = listn(0, cnt + 1);
-                listn(1, cnt) = listn(1, cnt + 1);
-                listn(0, cnt + 1) = s;
-                listn(1, cnt + 1) = s(1);
-                p = 1;
-            }
-        }
-        if (p == 0)
-        {
-            break;
-        }
+        rows.push_back({list(0, cnt),
+                        list(1, cnt),
+                        std::move(listn(0, cnt)),
+                        std::move(listn(1, cnt))});
+    }
+    sort_list_rows(rows);
+    for (int cnt = 0; cnt < listmax; ++cnt)
+    {
+        auto& row = rows[static_cast<size_t>(cnt)];
+        list(0, cnt) = row.value;
+        list(1, cnt) = row.sort_key;
+        listn(0, cnt) = std::move(row.name);
+        listn(1, cnt) = std::move(row.name2);
     }
 }
 
@@ -7420,7 +7439,7 @@ int do_cast_magic_attempt()
                     "core.ui.cast_style", cdata[cc].special_attack_type)));
         }
     }
-    if (buff_has(cdata[cc], "core.mist_of_silence"))
+    if (buff_has(cdata[cc], ELONA_SHARED_ID("core.mist_of_silence")))
     {
         if (is_in_fov(cdata[cc]))
         {
@@ -8471,6 +8490,7 @@ int pick_up_item(bool play_sound)
                     inv[ti].param3 = inv[ti].param3 - game_data.date.hours();
                 }
             }
+            food_expiration_schedule.add(inv[ti]);
         }
         if (invctrl == 11)
         {
@@ -10761,6 +10781,7 @@ void discover_hidden_path()
 {
     cell_data.at(refx, refy).chip_id_actual = tile_tunnel;
     cell_featset(refx, refy, 0, 0);
+    flow_fields.notify_cell_changed(refx, refy);
 }
 
 
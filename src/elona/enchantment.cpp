@@ -2,6 +2,7 @@
 #include "../util/range.hpp"
 #include "data/types/type_ability.hpp"
 #include "data/types/type_item.hpp"
+#include "derived_stats.hpp"
 #include "element.hpp"
 #include "elona.hpp"
 #include "i18n.hpp"
@@ -812,6 +813,7 @@ bool enchantment_add(
         item.value = item.value * encref(1, p_at_m48) / 100;
     }
     enchantment_sort(item);
+    enchantment_on_changed(item);
 
     return true;
 }
@@ -841,30 +843,24 @@ void enchantment_remove(Item& item, int id, int power)
     item.value = item.value * 100 / encref(1, id < 10000 ? id : id / 10000);
 
     enchantment_sort(item);
+    enchantment_on_changed(item);
 }
 
 
 
-optional<int> enchantment_find(const Character& chara, int id)
+void enchantment_on_changed(const Item& item)
 {
-    optional<int> max;
-
-    for (const auto& body_part : chara.body_parts)
+    if (item.body_part != 0)
     {
-        if (body_part % 10000 == 0)
-            continue;
-
-        const auto& equip = inv[body_part % 10000 - 1];
-        if (const auto power = enchantment_find(equip, id))
-        {
-            if (!max || *max < *power)
-            {
-                max = power;
-            }
-        }
+        equipped_enchantments.invalidate_all();
     }
+}
+
 
-    return max;
+
+optional<int> enchantment_find(const Character& chara, int id)
+{
+    return equipped_enchantments.get(chara).max(id);
 }
 
 
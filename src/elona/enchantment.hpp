@@ -35,6 +35,14 @@ void enchantment_remove(Item& item, int id, int power);
 
 
 
+/**
+ * To be called after changing an item's enchantments directly, so that the
+ * enchantments of the character equipping it are looked up again.
+ */
+void enchantment_on_changed(const Item& item);
+
+
+
 /**
  * Find enchantments from chara's equipments.
  *
@@ -0,0 +1,265 @@
+#include "flow_field.hpp"
+#include <algorithm>
+#include <functional>
+#include "map.hpp"
+
+
+
+namespace
+{
+
+constexpr int closed_door_feat_id = 21;
+
+constexpr std::array<std::array<int, 2>, 8> neighbors{{
+    {{0, -1}},
+    {{-1, 0}},
+    {{1, 0}},
+    {{0, 1}},
+    {{-1, -1}},
+    {{1, -1}},
+    {{-1, 1}},
+    {{1, 1}},
+}};
+
+} // namespace
+
+
+
+namespace elona
+{
+
+FlowFieldManager flow_fields;
+
+
+
+bool flow_field_is_walkable(int x, int y)
+{
+    if (x < 0 || x >= map_data.width || y < 0 || y >= map_data.height)
+    {
+        return false;
+    }
+    if (chip_data.for_cell(x, y).effect & 4)
+    {
+        return false;
+    }
+    const auto feats = cell_data.at(x, y).feats;
+    if (feats != 0 && feats / 1000 % 100 != closed_door_feat_id)
+    {
+        if (chip_data.for_feat(x, y).effect & 4)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+
+bool FlowField::matches_current_map() const
+{
+    return _width == map_data.width && _height == map_data.height;
+}
+
+
+
+void FlowField::_resize()
+{
+    _width = map_data.width;
+    _height = map_data.height;
+    _distances.assign(static_cast<size_t>(_width * _height), unreachable);
+}
+
+
+
+void FlowField::_push(int distance, int index)
+{
+    _heap.emplace_back(distance, index);
+    std::push_heap(_heap.begin(), _heap.end(), std::greater<>{});
+}
+
+
+
+void FlowField::_propagate()
+{
+    while (!_heap.empty())
+    {
+        std::pop_heap(_heap.begin(), _heap.end(), std::greater<>{});
+        const auto node = _heap.back();
+        _heap.pop_back();
+
+        const auto distance = node.first;
+        if (distance > _distances[static_cast<size_t>(node.second)])
+        {
+            continue; // Stale entry.
+        }
+
+        const auto x = node.second % _width;
+        const auto y = node.second / _width;
+        for (const auto& d : neighbors)
+        {
+            const auto nx = x + d[0];
+            const auto ny = y + d[1];
+            if (!flow_field_is_walkable(nx, ny))
+            {
+                continue;
+            }
+            const auto index = ny * _width + nx;
+            if (distance + 1 < _distances[static_cast<size_t>(index)])
+            {
+                _distances[static_cast<size_t>(index)] = distance + 1;
+                _push(distance + 1, index);
+            }
+        }
+    }
+}
+
+
+
+void FlowField::build_towards(const Position& goal)
+{
+    _goal = goal;
+    _resize();
+    if (goal.x < 0 || goal.x >= _width || goal.y < 0 || goal.y >= _height)
+    {
+        return;
+    }
+
+    const auto index = goal.y * _width + goal.x;
+    _distances[static_cast<size_t>(index)] = 0;
+    _push(0, index);
+    _propagate();
+}
+
+
+
+void FlowField::build_away_from(const FlowField& towards)
+{
+    _goal = towards._goal;
+    _resize();
+
+    // Negate and scale the distances so that fleeing characters prefer
+    // running past the goal into open areas rather than into corners, then
+    // let every cell settle against its neighbors.
+    _heap.clear();
+    for (size_t i = 0; i < towards._distances.size(); ++i)
+    {
+        if (towards._distances[i] == unreachable)
+        {
+            continue;
+        }
+        _distances[i] = -(towards._distances[i] * 6 / 5);
+        _heap.emplace_back(_distances[i], static_cast<int>(i));
+    }
+    std::make_heap(_heap.begin(), _heap.end(), std::greater<>{});
+    _propagate();
+}
+
+
+
+void FlowField::open_cell(int x, int y)
+{
+    if (!flow_field_is_walkable(x, y) || at(x, y) != unreachable)
+    {
+        return;
+    }
+
+    int best = unreachable;
+    for (const auto& d : neighbors)
+    {
+        best = std::min(best, at(x + d[0], y + d[1]));
+    }
+    if (best == unreachable)
+    {
+        return; // Still disconnected from the goal.
+    }
+
+    const auto index = y * _width + x;
+    _distances[static_cast<size_t>(index)] = best + 1;
+    _push(best + 1, index);
+    _propagate();
+}
+
+
+
+FlowFieldManager::Entry& FlowFieldManager::_get(const Position& goal)
+{
+    ++_clock;
+
+    auto it = std::find_if(
+        _entries.begin(), _entries.end(), [&](const Entry& entry) {
+            return entry.valid && entry.towards.goal() == goal &&
+                entry.towards.matches_current_map();
+        });
+    if (it == _entries.end())
+    {
+        it = std::min_element(
+            _entries.begin(),
+            _entries.end(),
+            [](const Entry& a, const Entry& b) {
+                return a.last_used < b.last_used;
+            });
+        it->towards.build_towards(goal);
+        it->valid = true;
+        it->away_valid = false;
+    }
+    it->last_used = _clock;
+    return *it;
+}
+
+
+
+const FlowField& FlowFieldManager::towards(const Position& goal)
+{
+    return _get(goal).towards;
+}
+
+
+
+const FlowField& FlowFieldManager::away_from(const Position& goal)
+{
+    auto& entry = _get(goal);
+    if (!entry.away_valid)
+    {
+        entry.away.build_away_from(entry.towards);
+        entry.away_valid = true;
+    }
+    return entry.away;
+}
+
+
+
+void FlowFieldManager::invalidate()
+{
+    for (auto&& entry : _entries)
+    {
+        entry.valid = false;
+        entry.away_valid = false;
+    }
+}
+
+
+
+void FlowFieldManager::notify_cell_changed(int x, int y)
+{
+    const auto walkable = flow_field_is_walkable(x, y);
+    for (auto&& entry : _entries)
+    {
+        if (!entry.valid)
+        {
+            continue;
+        }
+        if (walkable)
+        {
+            entry.towards.open_cell(x, y);
+        }
+        else if (entry.towards.at(x, y) != FlowField::unreachable)
+        {
+            // A blocked cell can lengthen any path through it; rebuild the
+            // field on its next use.
+            entry.valid = false;
+        }
+        entry.away_valid = false;
+    }
+}
+
+} // namespace elona
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <array>
+#include <limits>
+#include <vector>
+#include "position.hpp"
+
+
+
+namespace elona
+{
+
+/**
+ * Distance map over the walkable cells of the current map, computed with
+ * Dijkstra's algorithm from one goal cell. Once built, any number of
+ * characters can look up their distance to the goal (and therefore the best
+ * next step) in O(1).
+ *
+ * Only the terrain is taken into account. Characters move every turn, so they
+ * are left to the caller (see `cell_check()`).
+ */
+class FlowField
+{
+public:
+    static constexpr int unreachable = std::numeric_limits<int>::max();
+
+
+    /**
+     * Computes the distance from every walkable cell to @a goal.
+     */
+    void build_towards(const Position& goal);
+
+    /**
+     * Computes a "safety map" from a field built by `build_towards()`. Going
+     * downhill on the result moves away from the goal of @a towards, but
+     * prefers open areas over dead ends.
+     */
+    void build_away_from(const FlowField& towards);
+
+    /**
+     * Updates the field after the cell (@a x, @a y) became walkable, e.g.,
+     * when a wall is dug. Distances can only decrease, so only the affected
+     * region is relaxed.
+     */
+    void open_cell(int x, int y);
+
+
+    int at(int x, int y) const
+    {
+        if (x < 0 || x >= _width || y < 0 || y >= _height)
+        {
+            return unreachable;
+        }
+        return _distances[static_cast<size_t>(y * _width + x)];
+    }
+
+
+    const Position& goal() const
+    {
+        return _goal;
+    }
+
+
+    bool matches_current_map() const;
+
+
+private:
+    using Node = std::pair<int, int>; // (distance, cell index)
+
+    void _resize();
+    void _push(int distance, int index);
+    void _propagate();
+
+    Position _goal;
+    int _width{};
+    int _height{};
+    std::vector<int> _distances;
+    std::vector<Node> _heap; // Kept to reuse its storage between builds.
+};
+
+
+
+/**
+ * Shared flow fields for the current map, keyed by goal position. NPCs
+ * chasing or fleeing from the same character share one field, which is
+ * rebuilt only when its goal moves or the terrain changes.
+ */
+class FlowFieldManager
+{
+public:
+    const FlowField& towards(const Position& goal);
+    const FlowField& away_from(const Position& goal);
+
+    /**
+     * Drops every field. To be called when the current map changes.
+     */
+    void invalidate();
+
+    /**
+     * Notifies that the walkability of (@a x, @a y) may have changed.
+     */
+    void notify_cell_changed(int x, int y);
+
+
+private:
+    static constexpr size_t cache_size = 4;
+
+    struct Entry
+    {
+        FlowField towards;
+        FlowField away;
+        bool valid = false;
+        bool away_valid = false;
+        int last_used = 0;
+    };
+
+    Entry& _get(const Position& goal);
+
+    std::array<Entry, cache_size> _entries;
+    int _clock = 0;
+};
+
+
+
+extern FlowFieldManager flow_fields;
+
+
+/**
+ * Returns whether the cell can be passed by a walking character, ignoring
+ * other characters. Closed doors are walkable since NPCs open them.
+ */
+bool flow_field_is_walkable(int x, int y);
+
+} // namespace elona
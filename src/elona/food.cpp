@@ -1,4 +1,5 @@
 #include "food.hpp"
+#include <algorithm>
 #include "../util/strutil.hpp"
 #include "ability.hpp"
 #include "audio.hpp"
@@ -463,6 +464,7 @@ void make_dish(Item& food, int dish_rank)
     if (food.material == 35 && 0 <= food.param3)
     {
         food.param3 = game_data.date.hours() + 72;
+        food_expiration_schedule.add(food);
     }
 }
 
@@ -1478,7 +1480,92 @@ foodname(int type, const std::string& ingredient_, int rank, int character_id)
 
 
 
+FoodExpirationSchedule food_expiration_schedule;
+
+
+
+void FoodExpirationSchedule::add(const Item& item)
+{
+    if (!_is_valid)
+    {
+        return; // It will be found when rebuilding.
+    }
+    if (item.index < 0 || ELONA_MAX_ITEMS <= item.index)
+    {
+        return; // Not in `inv`.
+    }
+    if (item.number() == 0 || item.material != 35 || item.param3 <= 0)
+    {
+        return;
+    }
+    _heap.emplace(item.param3, item.index);
+}
+
+
+
+void FoodExpirationSchedule::invalidate()
+{
+    _is_valid = false;
+}
+
+
+
+std::vector<int> FoodExpirationSchedule::pop_due(int now)
+{
+    if (!_is_valid)
+    {
+        _rebuild();
+    }
+
+    std::vector<int> ret;
+    while (!_heap.empty() && _heap.top().first <= now)
+    {
+        ret.push_back(_heap.top().second);
+        _heap.pop();
+    }
+    std::sort(std::begin(ret), std::end(ret));
+    ret.erase(std::unique(std::begin(ret), std::end(ret)), std::end(ret));
+    return ret;
+}
+
+
+
+void FoodExpirationSchedule::_rebuild()
+{
+    _heap = {};
+    _is_valid = true;
+    for (const auto& item : inv.all())
+    {
+        add(item);
+    }
+}
+
+
+
 void foods_get_rotten()
+{
+    for (const auto item_index : food_expiration_schedule.pop_due(
+             game_data.date.hours()))
+    {
+        auto& item = inv[item_index];
+        if (item.number() == 0)
+        {
+            continue;
+        }
+        const auto chara = inv_getowner(item_index);
+        if (chara == -1 || cdata[chara].state() != Character::State::empty)
+        {
+            _food_gets_rotten(chara, item);
+        }
+        // Foods which could not get rotten this time, e.g., ones on the field,
+        // are due again the next hour; dried corpses have a new date.
+        food_expiration_schedule.add(item);
+    }
+}
+
+
+
+void foods_get_rotten_fully()
 {
     for (int j = 0; j < ELONA_MAX_CHARACTERS + 1; ++j)
     {
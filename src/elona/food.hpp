@@ -1,6 +1,10 @@
 #pragma once
 
+#include <functional>
+#include <queue>
 #include <string>
+#include <utility>
+#include <vector>
 
 
 
@@ -35,6 +39,48 @@ void apply_general_eating_effect(int);
 
 std::string foodname(int, const std::string&, int = 0, int = 0);
 
+/**
+ * Expiration dates of the foods in `inv`, so that the hourly tick touches
+ * only the foods whose date has come instead of every item.
+ *
+ * Items are added when created or copied to another slot. Dates which have
+ * moved later are found when they pop and are added again. The schedule is
+ * rebuilt from all items after `inv` has been read from a file.
+ */
+class FoodExpirationSchedule
+{
+public:
+    /**
+     * Adds @a item if it is a food which has not got rotten yet. Adding an
+     * item twice is harmless.
+     */
+    void add(const Item& item);
+
+    void invalidate();
+
+    /**
+     * Removes and returns the indices of the items whose expiration date is
+     * not after @a now, in ascending order, i.e., the order `inv` is scanned.
+     */
+    std::vector<int> pop_due(int now);
+
+
+private:
+    using Entry = std::pair<int, int>; // Expiration date and item index.
+
+    void _rebuild();
+
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> _heap;
+    bool _is_valid = false;
+};
+
+extern FoodExpirationSchedule food_expiration_schedule;
+
 void foods_get_rotten();
 
+/**
+ * Same as `foods_get_rotten()`, but checks every item, as it used to.
+ */
+void foods_get_rotten_fully();
+
 } // namespace elona
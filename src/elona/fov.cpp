@@ -1,4 +1,5 @@
 #include "fov.hpp"
+#include "../util/allocation_profiler.hpp"
 #include "character.hpp"
 #include "map.hpp"
 #include "variables.hpp"
@@ -7,6 +8,7 @@ namespace elona
 {
 
 std::array<std::array<int, 2>, 17> fovlist;
+VisibleCells visible_cells;
 
 int dy_at_modfov = 0;
 int dx_at_modfov = 0;
@@ -38,6 +40,8 @@ bool is_in_fov(const Character& cc)
 
 int fov_los(int x1, int y1, int x2, int y2)
 {
+    ELONA_ALLOCATION_SCOPE("fov");
+
     if (x1 < 0 || map_data.width <= x1 || y1 < 0 || map_data.height <= y1 ||
         x2 < 0 || map_data.width <= x2 || y2 < 0 || map_data.height <= y2)
     {
@@ -304,8 +308,17 @@ int fov_los(int x1, int y1, int x2, int y2)
 
 int get_route(int x1, int y1, int x2, int y2)
 {
+    ELONA_ALLOCATION_SCOPE("fov");
+
     int p_at_modfov = 0;
-    DIM3(route, 2, 100);
+    if (route.j_size() < 100)
+    {
+        DIM3(route, 2, 100);
+    }
+    else
+    {
+        route.clear();
+    }
     dy_at_modfov = y2 - y1;
     dx_at_modfov = x2 - x1;
     if (y2 == y1)
@@ -698,4 +711,67 @@ void init_fovlist()
 
 
 
+void VisibleCells::reset()
+{
+    _width = 0;
+    _height = 0;
+    _current.clear();
+    _previous.clear();
+    _entered.clear();
+    _left.clear();
+}
+
+
+
+void VisibleCells::begin_update(int width, int height)
+{
+    if (width != _width || height != _height)
+    {
+        reset();
+        _width = width;
+        _height = height;
+        _current.resize((static_cast<size_t>(width * height) + 63) / 64);
+    }
+    _previous.swap(_current);
+    _current.assign(_previous.size(), 0);
+}
+
+
+
+void VisibleCells::add(int x, int y)
+{
+    const auto index = static_cast<size_t>(y * _width + x);
+    _current[index / 64] |= uint64_t{1} << (index % 64);
+}
+
+
+
+void VisibleCells::end_update()
+{
+    _entered.clear();
+    _left.clear();
+    for (size_t word = 0; word < _current.size(); ++word)
+    {
+        // Only the cells in words which differ are looked at.
+        auto changed = _current[word] ^ _previous[word];
+        for (size_t bit = 0; changed != 0; ++bit, changed >>= 1)
+        {
+            if (!(changed & 1))
+            {
+                continue;
+            }
+            const auto index = static_cast<int>(word * 64 + bit);
+            const Position pos{index % _width, index / _width};
+            if (_current[word] & (uint64_t{1} << bit))
+            {
+                _entered.push_back(pos);
+            }
+            else
+            {
+                _left.push_back(pos);
+            }
+        }
+    }
+}
+
 } // namespace elona
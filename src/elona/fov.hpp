@@ -1,13 +1,15 @@
 #pragma once
 
 #include <array>
+#include <cstdint>
+#include <vector>
+#include "position.hpp"
 
 
 
 namespace elona
 {
 
-struct Position;
 struct Character;
 
 constexpr int fov_max = 15; // in diameter
@@ -21,4 +23,50 @@ int fov_los(int = 0, int = 0, int = 0, int = 0);
 int get_route(int = 0, int = 0, int = 0, int = 0);
 void init_fovlist();
 
+
+
+/**
+ * The cells the PC saw at the last `update_slight()`, kept as a bitset, with
+ * the cells which came into or went out of sight since the update before it.
+ * `mapsync` still marks the same cells for the code which reads it directly.
+ */
+class VisibleCells
+{
+public:
+    /**
+     * Forgets every cell without reporting them as left, as when the map
+     * changes.
+     */
+    void reset();
+
+    void begin_update(int width, int height);
+    void add(int x, int y);
+    void end_update();
+
+
+    const std::vector<Position>& entered() const
+    {
+        return _entered;
+    }
+
+
+    const std::vector<Position>& left() const
+    {
+        return _left;
+    }
+
+
+private:
+    int _width = 0;
+    int _height = 0;
+    std::vector<uint64_t> _current;
+    std::vector<uint64_t> _previous;
+    std::vector<Position> _entered;
+    std::vector<Position> _left;
+};
+
+
+
+extern VisibleCells visible_cells;
+
 } // namespace elona
@@ -12,7 +12,9 @@
 #include "deferred_event.hpp"
 #include "draw.hpp"
 #include "elona.hpp"
+#include "flow_field.hpp"
 #include "food.hpp"
+#include "fov.hpp"
 #include "i18n.hpp"
 #include "item.hpp"
 #include "itemgen.hpp"
@@ -1161,6 +1163,7 @@ static void _init_tileset_minimap_and_scroll()
     scx = cdata.player().position.x;
     scy = cdata.player().position.y;
     msync = 1;
+    visible_cells.reset();
     draw_prepare_map_chips();
     ui_initialize_minimap();
     update_scrolling_info();
@@ -1306,6 +1309,7 @@ init_map_before_refresh:
     _proc_map_refresh();
 init_map_after_refresh:
     DIM4(efmap, 4, map_data.width, map_data.height);
+    flow_fields.invalidate();
     if (map_data.width == 0 || map_data.height == 0)
     {
         if (medit == 0)
@@ -9,6 +9,7 @@
 #include "enums.hpp"
 #include "i18n.hpp"
 #include "input_prompt.hpp"
+#include "input_recorder.hpp"
 #include "keybind/input_context.hpp"
 #include "keybind/keybind.hpp"
 #include "ui.hpp"
@@ -145,7 +146,7 @@ void input_number_dialog(int x, int y, int max_number, int initial_number)
 
 
 
-bool input_text_dialog(
+static bool _input_text_dialog(
     int x,
     int y,
     int val2,
@@ -278,11 +279,44 @@ bool input_text_dialog(
     return canceled;
 }
 
+
+
+bool input_text_dialog(
+    int x,
+    int y,
+    int val2,
+    bool is_cancelable,
+    bool limit_length)
+{
+    auto& recorder = InputRecorder::instance();
+    if (recorder.is_replaying())
+    {
+        const auto answer = recorder.replay_text();
+        inputlog = answer.second;
+        if (answer.first)
+        {
+            keywait = 1;
+            key = "";
+        }
+        keyhalt = 1;
+        return answer.first;
+    }
+
+    bool canceled;
+    {
+        InputRecorder::ScopedPause pause;
+        canceled =
+            _input_text_dialog(x, y, val2, is_cancelable, limit_length);
+    }
+    recorder.record_text(canceled, inputlog(0));
+    return canceled;
+}
+
 static void _proc_android_vibrate()
 {
-    if (config_get_boolean("core.android.vibrate"))
+    if (g_config.vibrate())
     {
-        int duration = config_get_integer("core.android.vibrate_duration");
+        int duration = g_config.vibrate_duration();
         snail::android::vibrate(static_cast<long>(duration * 25));
     }
 }
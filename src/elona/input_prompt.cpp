@@ -4,6 +4,7 @@
 #include "draw.hpp"
 #include "i18n.hpp"
 #include "input.hpp"
+#include "input_recorder.hpp"
 #include "keybind/keybind.hpp"
 #include "ui.hpp"
 
@@ -13,6 +14,25 @@ namespace elona
 int _show_prompt_val{};
 
 int Prompt::query(int x, int y, int width)
+{
+    auto& recorder = InputRecorder::instance();
+    if (recorder.is_replaying())
+    {
+        const auto answer = recorder.replay_prompt();
+        _show_prompt_val = answer.second;
+        return answer.first;
+    }
+
+    int ret;
+    {
+        InputRecorder::ScopedPause pause;
+        ret = _query(x, y, width);
+    }
+    recorder.record_prompt(ret, _show_prompt_val);
+    return ret;
+}
+
+int Prompt::_query(int x, int y, int width)
 {
     snd("core.pop2");
 
@@ -72,6 +72,7 @@ protected:
     I18NKey _locale_key_root;
 
 private:
+    int _query(int x, int y, int width);
     void _draw_keys_and_background(int x, int y, int width);
     void _draw_main_frame(int width);
     void _draw_entries();
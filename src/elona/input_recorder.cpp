@@ -0,0 +1,306 @@
+#include "input_recorder.hpp"
+#include <sstream>
+#include <stdexcept>
+#include "../util/filepathutil.hpp"
+#include "log.hpp"
+#include "variables.hpp"
+
+
+
+namespace
+{
+
+constexpr const char* _magic = "elona_input_record";
+
+constexpr int _format_version = 1;
+
+// Bits of an action record's flags.
+constexpr int _flag_running = 1;
+constexpr int _flag_key_escape = 2;
+
+} // namespace
+
+
+
+namespace elona
+{
+
+InputRecorder& InputRecorder::instance()
+{
+    static InputRecorder the_instance;
+    return the_instance;
+}
+
+
+
+fs::path InputRecorder::snapshot_dir(const fs::path& filepath)
+{
+    auto dir = filepath;
+    dir += ".save";
+    return dir;
+}
+
+
+
+void InputRecorder::start_recording(
+    const fs::path& filepath,
+    const std::string& player_id,
+    int seed)
+{
+    stop();
+
+    const auto snapshot = snapshot_dir(filepath);
+    if (fs::exists(snapshot))
+    {
+        fs::remove_all(snapshot);
+    }
+    filesystem::copy_recursively(filesystem::dirs::save(player_id), snapshot);
+
+    _out.open(filepath.native());
+    if (!_out)
+    {
+        throw std::runtime_error{"Failed to open input record: " +
+                                 filepathutil::to_utf8_path(filepath)};
+    }
+    _out << _magic << " " << _format_version << "\n";
+    _out << "player " << player_id << "\n";
+    _out << "seed " << seed << "\n";
+
+    _header = {player_id, seed};
+    _mode = Mode::recording;
+    ELONA_LOG("input") << "Recording input to "
+                       << filepathutil::to_utf8_path(filepath);
+}
+
+
+
+void InputRecorder::start_replaying(const fs::path& filepath)
+{
+    stop();
+
+    std::ifstream in{filepath.native()};
+    const auto fail = [&](const std::string& reason) {
+        throw std::runtime_error{"Invalid input record " +
+                                 filepathutil::to_utf8_path(filepath) + ": " +
+                                 reason};
+    };
+
+    std::string magic;
+    int version;
+    if (!(in >> magic >> version) || magic != _magic)
+    {
+        fail("not an input record");
+    }
+    if (version != _format_version)
+    {
+        fail("unsupported version " + std::to_string(version));
+    }
+
+    Header header;
+    std::string key;
+    if (!(in >> key) || key != "player" || in.get() != ' ' ||
+        !std::getline(in, header.player_id))
+    {
+        fail("missing player");
+    }
+    if (!(in >> key >> header.seed) || key != "seed")
+    {
+        fail("missing seed");
+    }
+
+    std::deque<Record> records;
+    std::string line;
+    std::getline(in, line);
+    while (std::getline(in, line))
+    {
+        if (line.empty())
+        {
+            continue;
+        }
+
+        Record record;
+        record.type = line[0];
+        std::istringstream fields{line.substr(1)};
+        size_t count;
+        switch (record.type)
+        {
+        case 'a': count = 4; break;
+        case 'i': count = 1; break;
+        case 'p': count = 2; break;
+        case 't': count = 1; break;
+        default: fail("unknown record '" + line + "'"); return;
+        }
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (!(fields >> record.numbers[i]))
+            {
+                fail("malformed record '" + line + "'");
+            }
+        }
+        if (fields.get() == ' ')
+        {
+            std::getline(fields, record.text);
+        }
+        records.push_back(std::move(record));
+    }
+
+    _header = std::move(header);
+    _records = std::move(records);
+    _mode = Mode::replaying;
+    ELONA_LOG("input") << "Replaying " << _records.size()
+                       << " input records from "
+                       << filepathutil::to_utf8_path(filepath);
+}
+
+
+
+void InputRecorder::stop()
+{
+    if (_out.is_open())
+    {
+        _write_idle_polls();
+        _out.close();
+    }
+    _records.clear();
+    _idle_polls = 0;
+    _mode = Mode::none;
+}
+
+
+
+// Most polls find no input, so they are counted instead of written one by one.
+// They still have to be replayed, as the game may do work while waiting.
+void InputRecorder::record_action(const std::string& action)
+{
+    if (!is_recording() || _pause_depth > 0)
+    {
+        return;
+    }
+    if (action.empty())
+    {
+        ++_idle_polls;
+        return;
+    }
+
+    int flags = 0;
+    if (running != 0)
+    {
+        flags |= _flag_running;
+    }
+    if (key_escape)
+    {
+        flags |= _flag_key_escape;
+    }
+    _out << "a " << _idle_polls << " " << flags << " " << keybd_wait << " "
+         << keybd_attacking << " " << action << "\n";
+    _idle_polls = 0;
+}
+
+
+
+std::string InputRecorder::replay_action()
+{
+    if (!_records.empty() && _records.front().type == 'i')
+    {
+        if (--_records.front().numbers[0] <= 0)
+        {
+            _records.pop_front();
+        }
+        return "";
+    }
+
+    auto& record = _next_record('a');
+    if (record.numbers[0] > 0)
+    {
+        --record.numbers[0];
+        return "";
+    }
+
+    const auto flags = record.numbers[1];
+    running = (flags & _flag_running) != 0 ? 1 : 0;
+    key_escape = (flags & _flag_key_escape) != 0;
+    keybd_wait = record.numbers[2];
+    keybd_attacking = record.numbers[3];
+
+    auto action = std::move(record.text);
+    _records.pop_front();
+    return action;
+}
+
+
+
+void InputRecorder::record_prompt(int result, int number)
+{
+    if (!is_recording() || _pause_depth > 0)
+    {
+        return;
+    }
+    _write_idle_polls();
+    _out << "p " << result << " " << number << "\n";
+}
+
+
+
+std::pair<int, int> InputRecorder::replay_prompt()
+{
+    const auto record = _next_record('p');
+    _records.pop_front();
+    return {record.numbers[0], record.numbers[1]};
+}
+
+
+
+void InputRecorder::record_text(bool canceled, const std::string& text)
+{
+    if (!is_recording() || _pause_depth > 0)
+    {
+        return;
+    }
+    _write_idle_polls();
+    _out << "t " << (canceled ? 1 : 0) << " " << text << "\n";
+}
+
+
+
+std::pair<bool, std::string> InputRecorder::replay_text()
+{
+    auto record = _next_record('t');
+    _records.pop_front();
+    return {record.numbers[0] != 0, std::move(record.text)};
+}
+
+
+
+// Polls are only written with the action which ends them. Those before a
+// prompt, text input or the end of the record get a record of their own.
+void InputRecorder::_write_idle_polls()
+{
+    if (_idle_polls > 0)
+    {
+        _out << "i " << _idle_polls << "\n";
+        _idle_polls = 0;
+    }
+}
+
+
+
+// Returns the next record, which the game expects to be of @a type. Throws
+// if there is none left, or if the game asks for something else than was
+// recorded, which means the replay went out of sync.
+InputRecorder::Record& InputRecorder::_next_record(char type)
+{
+    if (_records.empty())
+    {
+        throw ReplayFinished{};
+    }
+    auto& record = _records.front();
+    if (record.type != type)
+    {
+        throw ReplayOutOfSync{
+            std::string{"Replay out of sync: expected input of type '"} +
+            type + "', but the record has '" + record.type + "'"};
+    }
+    return record;
+}
+
+} // namespace elona
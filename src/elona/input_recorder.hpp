@@ -0,0 +1,156 @@
+#pragma once
+
+#include <array>
+#include <deque>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include "../util/noncopyable.hpp"
+#include "filesystem.hpp"
+
+
+
+namespace elona
+{
+
+/**
+ * Records what the player entered in a session, so that it can be replayed:
+ * the random seed, and the actions, prompt answers and text input in the
+ * order the game asked for them. A copy of the save is kept next to the
+ * record, so that the replay starts from the same state.
+ *
+ * When replaying, the game gets the recorded input back without waiting for
+ * the player. See `simulation::Options::replay`.
+ */
+class InputRecorder : public lib::noncopyable
+{
+public:
+    struct Header
+    {
+        std::string player_id;
+        int seed = 0;
+    };
+
+    /**
+     * Thrown when the game asks for input after all recorded input has been
+     * replayed.
+     */
+    struct ReplayFinished
+    {
+    };
+
+    /**
+     * Thrown when the game asks for another kind of input than was recorded.
+     */
+    struct ReplayOutOfSync : public std::runtime_error
+    {
+        using std::runtime_error::runtime_error;
+    };
+
+    /**
+     * Stops recording while alive. Used by prompts, which record their answer
+     * instead of the actions leading to it.
+     */
+    class ScopedPause : public lib::noncopyable
+    {
+    public:
+        ScopedPause()
+        {
+            ++InputRecorder::instance()._pause_depth;
+        }
+
+        ~ScopedPause()
+        {
+            --InputRecorder::instance()._pause_depth;
+        }
+    };
+
+
+    static InputRecorder& instance();
+
+    /**
+     * The directory the save is copied to when recording to @a filepath.
+     */
+    static fs::path snapshot_dir(const fs::path& filepath);
+
+    bool is_recording() const
+    {
+        return _mode == Mode::recording;
+    }
+
+    bool is_replaying() const
+    {
+        return _mode == Mode::replaying;
+    }
+
+    const Header& header() const
+    {
+        return _header;
+    }
+
+    /**
+     * Starts recording to @a filepath, copying the current save of
+     * @a player_id. The caller has to seed the random engine with @a seed
+     * when the recorded session starts.
+     */
+    void start_recording(
+        const fs::path& filepath,
+        const std::string& player_id,
+        int seed);
+
+    /**
+     * Reads all of the record at @a filepath and starts replaying it.
+     */
+    void start_replaying(const fs::path& filepath);
+
+    void stop();
+
+
+    // The record_*() functions do nothing unless recording. The replay_*()
+    // ones throw ReplayFinished or ReplayOutOfSync when the next record is
+    // not what the game asks for.
+    void record_action(const std::string& action);
+    std::string replay_action();
+
+    // The index of the chosen entry, and the number for prompts with one.
+    void record_prompt(int result, int number);
+    std::pair<int, int> replay_prompt();
+
+    void record_text(bool canceled, const std::string& text);
+    std::pair<bool, std::string> replay_text();
+
+
+private:
+    enum class Mode
+    {
+        none,
+        recording,
+        replaying,
+    };
+
+    // One line of the record file: a type character, some numbers and
+    // optionally a string, which is the rest of the line.
+    struct Record
+    {
+        char type = 0;
+        std::array<int, 4> numbers{};
+        std::string text;
+    };
+
+    void _write_idle_polls();
+    Record& _next_record(char type);
+
+
+    Mode _mode = Mode::none;
+    Header _header;
+    int _pause_depth = 0;
+
+    // Polls which did not result in an action since the last record.
+    int _idle_polls = 0;
+
+    std::ofstream _out;
+    std::deque<Record> _records;
+};
+
+} // namespace elona
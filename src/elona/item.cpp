@@ -1,6 +1,8 @@
 #include "item.hpp"
+#include <array>
 #include <iostream>
 #include <type_traits>
+#include "../util/allocation_profiler.hpp"
 #include "../util/strutil.hpp"
 #include "ability.hpp"
 #include "activity.hpp"
@@ -339,8 +341,10 @@ int mapitemfind(int x, int y, int id)
 
 void cell_refresh(int x, int y)
 {
+    ELONA_ALLOCATION_SCOPE("cell");
+
     int p_at_m55 = 0;
-    elona_vector1<int> n_at_m55;
+    std::array<int, 3> n_at_m55{};
     int cnt2_at_m55 = 0;
     int i_at_m55 = 0;
     if (mode == 6 || mode == 9)
@@ -387,7 +391,7 @@ void cell_refresh(int x, int y)
     }
     else if (p_at_m55 > 1)
     {
-        n_at_m55(2) = 0;
+        n_at_m55[2] = 0;
         for (int cnt = 0, cnt_end = (p_at_m55); cnt < cnt_end; ++cnt)
         {
             cnt2_at_m55 = cnt;
@@ -396,33 +400,33 @@ void cell_refresh(int x, int y)
             {
                 if (cnt2_at_m55 == 1)
                 {
-                    if (cnt == n_at_m55(0))
+                    if (cnt == n_at_m55[0])
                     {
                         continue;
                     }
                 }
                 if (cnt2_at_m55 == 2)
                 {
-                    if (cnt == n_at_m55(0) || cnt == n_at_m55(1))
+                    if (cnt == n_at_m55[0] || cnt == n_at_m55[1])
                     {
                         continue;
                     }
                 }
                 if (inv[floorstack(cnt)].turn > i_at_m55)
                 {
-                    n_at_m55(cnt2_at_m55) = cnt;
+                    n_at_m55[cnt2_at_m55] = cnt;
                     i_at_m55 = inv[floorstack(cnt)].turn;
                 }
             }
         }
         cell_data.at(x, y).item_appearances_actual =
-            floorstack(n_at_m55(0)) - ELONA_ITEM_ON_GROUND_INDEX;
+            floorstack(n_at_m55[0]) - ELONA_ITEM_ON_GROUND_INDEX;
         cell_data.at(x, y).item_appearances_actual +=
-            (floorstack(n_at_m55(1)) - ELONA_ITEM_ON_GROUND_INDEX) * 1000;
+            (floorstack(n_at_m55[1]) - ELONA_ITEM_ON_GROUND_INDEX) * 1000;
         if (p_at_m55 > 2)
         {
             cell_data.at(x, y).item_appearances_actual +=
-                (floorstack(n_at_m55(2)) - ELONA_ITEM_ON_GROUND_INDEX) *
+                (floorstack(n_at_m55[2]) - ELONA_ITEM_ON_GROUND_INDEX) *
                 1000000;
         }
         else
@@ -487,6 +491,17 @@ void item_exchange(int a, int b)
 
 
 
+void Item::copy(const Item& from, Item& to)
+{
+    const auto index_save = to.index;
+    to = from;
+    to.index = index_save;
+
+    food_expiration_schedule.add(to);
+}
+
+
+
 void Item::remove()
 {
     number_ = 0;
@@ -1591,6 +1606,105 @@ label_0313_internal:
 
 
 
+ItemNameCache item_name_cache;
+
+
+
+void ItemNameCache::Key::assign(const Item& item, int number)
+{
+    number_arg = number;
+    jp = elona::jp;
+    id = item.id;
+    this->number = item.number();
+    quality = item.quality;
+    weight = item.weight;
+    identify_state = item.identify_state;
+    count = item.count;
+    dice_x = item.dice_x;
+    dice_y = item.dice_y;
+    damage_bonus = item.damage_bonus;
+    hit_bonus = item.hit_bonus;
+    dv = item.dv;
+    pv = item.pv;
+    curse_state = item.curse_state;
+    enhancement = item.enhancement;
+    own_state = item.own_state;
+    subname = item.subname;
+    material = item.material;
+    param1 = item.param1;
+    param2 = item.param2;
+    param3 = item.param3;
+    param4 = item.param4;
+    flags = item.has_charge() | item.is_precious() << 1 |
+        item.is_aphrodisiac() << 2 | item.has_cooldown_time() << 3 |
+        item.is_poisoned() << 4 | item.is_eternal_force() << 5;
+    hours = item.has_cooldown_time() ? game_data.date.hours() : 0;
+}
+
+
+
+bool ItemNameCache::Key::operator==(const Key& other) const
+{
+    return number_arg == other.number_arg && jp == other.jp &&
+        id == other.id && number == other.number &&
+        quality == other.quality && weight == other.weight &&
+        identify_state == other.identify_state && count == other.count &&
+        dice_x == other.dice_x && dice_y == other.dice_y &&
+        damage_bonus == other.damage_bonus && hit_bonus == other.hit_bonus &&
+        dv == other.dv && pv == other.pv &&
+        curse_state == other.curse_state &&
+        enhancement == other.enhancement && own_state == other.own_state &&
+        subname == other.subname && material == other.material &&
+        param1 == other.param1 && param2 == other.param2 &&
+        param3 == other.param3 && param4 == other.param4 &&
+        flags == other.flags && hours == other.hours;
+}
+
+
+
+const std::string& ItemNameCache::get(int item_index, int number)
+{
+    if (inv[item_index].subname >= 40000)
+    {
+        // Naming a godly item reseeds the RNG, which must happen each time
+        // to keep the random sequence as it was.
+        _uncached = itemname(item_index, number);
+        return _uncached;
+    }
+
+    if (_entries.empty())
+    {
+        _entries.resize(ELONA_MAX_ITEMS);
+    }
+
+    // `itemname()` does this first, and it may change the identify state.
+    item_checkknown(item_index);
+
+    Key key;
+    key.assign(inv[item_index], number);
+    auto& entry = _entries.at(static_cast<size_t>(item_index));
+    if (!entry.valid || !(entry.key == key))
+    {
+        entry.name = itemname(item_index, number);
+        // `itemname()` may fix up the item, e.g., invalid furniture names.
+        entry.key.assign(inv[item_index], number);
+        entry.valid = true;
+    }
+    return entry.name;
+}
+
+
+
+void ItemNameCache::clear()
+{
+    for (auto&& entry : _entries)
+    {
+        entry.valid = false;
+    }
+}
+
+
+
 void remain_make(int ci, int cc)
 {
     inv[ci].subname = charaid2int(cdata[cc].id);
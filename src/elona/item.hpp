@@ -2,6 +2,7 @@
 
 #include <bitset>
 #include <memory>
+#include <string>
 #include <vector>
 #include "../util/range.hpp"
 #include "consts.hpp"
@@ -214,12 +215,7 @@ public:
 #include "_putit/item.cpp"
 
 
-    static void copy(const Item& from, Item& to)
-    {
-        const auto index_save = to.index;
-        to = from;
-        to.index = index_save;
-    }
+    static void copy(const Item& from, Item& to);
 
 
 private:
@@ -395,4 +391,73 @@ void item_db_on_drink(Item& item, int legacy_id);
 
 std::vector<int> item_get_inheritance(const Item& item);
 
+
+
+/**
+ * Caches `itemname()` for menus, which build the names of all visible rows
+ * on every redraw. A name is reused as long as every input it was built from
+ * is unchanged, so identifying, stacking, enchanting or cursing an item needs
+ * no explicit invalidation.
+ */
+class ItemNameCache
+{
+public:
+    /**
+     * Same as `itemname(item_index, number)`.
+     */
+    const std::string& get(int item_index, int number = 0);
+
+    /**
+     * Forgets all names, e.g., after the known names of items have changed
+     * with loading another save.
+     */
+    void clear();
+
+
+private:
+    struct Key
+    {
+        int number_arg = 0;
+        bool jp = false;
+        ItemId id = ItemId::none;
+        int number = 0;
+        Quality quality = Quality::none;
+        int weight = 0;
+        IdentifyState identify_state = IdentifyState::unidentified;
+        int count = 0;
+        int dice_x = 0;
+        int dice_y = 0;
+        int damage_bonus = 0;
+        int hit_bonus = 0;
+        int dv = 0;
+        int pv = 0;
+        CurseState curse_state = CurseState::none;
+        int enhancement = 0;
+        int own_state = 0;
+        int subname = 0;
+        int material = 0;
+        int param1 = 0;
+        int param2 = 0;
+        int param3 = 0;
+        int param4 = 0;
+        int flags = 0; // Only the flags the name shows.
+        int hours = 0; // For the cooldown time.
+
+        void assign(const Item& item, int number);
+        bool operator==(const Key& other) const;
+    };
+
+    struct Entry
+    {
+        bool valid = false;
+        Key key;
+        std::string name;
+    };
+
+    std::vector<Entry> _entries;
+    std::string _uncached;
+};
+
+extern ItemNameCache item_name_cache;
+
 } // namespace elona
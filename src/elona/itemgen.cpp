@@ -5,6 +5,7 @@
 #include "character_status.hpp"
 #include "data/types/type_item.hpp"
 #include "enchantment.hpp"
+#include "food.hpp"
 #include "i18n.hpp"
 #include "item.hpp"
 #include "item_material.hpp"
@@ -475,6 +476,7 @@ optional<int> do_create_item(int slot, int x, int y)
     calc_furniture_value(inv[ci]);
 
     itemturn(inv[ci]);
+    food_expiration_schedule.add(inv[ci]);
 
     if (initnum != 0)
     {
@@ -2,6 +2,7 @@
 #include "../../util/range.hpp"
 #include "../audio.hpp"
 #include "../config.hpp"
+#include "../input_recorder.hpp"
 #include "../variables.hpp"
 #include "keybind_manager.hpp"
 #include "macro_action_queue.hpp"
@@ -438,6 +439,21 @@ optional<std::string> InputContext::_handle_macro_action(
 }
 
 std::string InputContext::check_for_command(KeyWaitDelay delay_type)
+{
+    auto& recorder = InputRecorder::instance();
+    if (recorder.is_replaying())
+    {
+        // Actions queued by mods were recorded when they were taken.
+        keybind::macro_action_queue.clear();
+        return recorder.replay_action();
+    }
+
+    auto action = _check_for_command(delay_type);
+    recorder.record_action(action);
+    return action;
+}
+
+std::string InputContext::_check_for_command(KeyWaitDelay delay_type)
 {
     if (!keybind::macro_action_queue.empty())
     {
@@ -52,6 +52,8 @@ public:
     static InputContext& for_menu();
 
 private:
+    std::string _check_for_command(KeyWaitDelay delay_type);
+
     /**
      * Adds all actions that are a part of the given category.
      */
@@ -1,13 +1,17 @@
 #include "console.hpp"
 
+#include <fstream>
+#include <iomanip>
 #include <regex>
 #include <sstream>
 #include <boost/algorithm/string/predicate.hpp>
 #include "../../snail/application.hpp"
+#include "../../snail/audio.hpp"
 #include "../../snail/blend_mode.hpp"
 #include "../../snail/input.hpp"
 #include "../../spider/http.hpp"
 #include "../../util/strutil.hpp"
+#include "../../util/zone_profiler.hpp"
 #include "../ability.hpp"
 #include "../character.hpp"
 #include "../config.hpp"
@@ -52,6 +56,23 @@ std::string _version_string()
         ", timestamp: " + latest_version.timestamp;
 }
 
+
+
+std::string _format_zones(
+    const std::vector<lib::ZoneProfiler::ZoneStats>& zones,
+    size_t max_count)
+{
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(3);
+    for (size_t i = 0; i < zones.size() && i < max_count; ++i)
+    {
+        ss << "  " << std::setw(24) << std::left << zones[i].name
+           << std::setw(10) << std::right << zones[i].seconds * 1000 << " ms"
+           << std::setw(8) << zones[i].count << "x\n";
+    }
+    return ss.str();
+}
+
 } // namespace
 
 
@@ -661,6 +682,44 @@ void Console::_init_builtin_lua_functions()
             [this](const auto& err) { print(err.what()); });
     };
 
+    funcs["sound_cache"] = [this]() {
+        const auto stats = snail::audio::sound_cache_stats();
+        std::stringstream ss;
+        ss << stats.count << " sounds, " << stats.bytes / 1024 << " / "
+           << stats.budget / 1024 << " KiB\n"
+           << "loads: " << stats.loads << ", hits: " << stats.hits
+           << ", evictions: " << stats.evictions;
+        print(ss.str());
+    };
+
+    funcs["profile"] = [this]() {
+#ifdef ELONA_PROFILE_ZONES
+        auto& profiler = lib::g_zone_profiler;
+        profiler.set_enabled(!profiler.is_enabled());
+        print(
+            profiler.is_enabled() ? "Zone profiling started."
+                                  : "Zone profiling stopped.");
+#else
+        print("Zone profiling is not compiled in (ELONA_PROFILE_ZONES).");
+#endif
+    };
+
+    funcs["profile_top"] = [this]() {
+        const auto& profiler = lib::g_zone_profiler;
+        print("Last turn:\n" + _format_zones(profiler.last_turn(), 10));
+        std::stringstream ss;
+        ss << "Slowest turn (" << std::fixed << std::setprecision(3)
+           << profiler.slowest_turn_seconds() * 1000 << " ms):\n";
+        print(ss.str() + _format_zones(profiler.slowest_turn(), 10));
+    };
+
+    funcs["profile_trace"] = [this]() {
+        const auto path = filesystem::dirs::log() / "trace.json";
+        std::ofstream out{path.native()};
+        lib::g_zone_profiler.write_chrome_trace(out);
+        print("Wrote " + filepathutil::to_utf8_path(path));
+    };
+
     // Map functions stored in COMMANDS._BUILTIN_ to global.
     for (auto&& pair : funcs)
     {
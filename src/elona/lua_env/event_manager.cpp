@@ -1,4 +1,5 @@
 #include "event_manager.hpp"
+#include "../../util/zone_profiler.hpp"
 #include "../log.hpp"
 #include "api_manager.hpp"
 #include "data_manager.hpp"
@@ -31,6 +32,8 @@ void EventManager::remove_unknown_events()
 
 EventResult EventManager::trigger(const BaseEvent& event)
 {
+    ELONA_PROFILE_ZONE("lua_event");
+
     sol::protected_function trigger = env()["Event"]["trigger"];
     auto result =
         trigger(event.id, event.make_event_table(), event.make_event_options());
@@ -33,6 +33,7 @@ void LuaApiData::reload_charas()
 {
     the_character_db.initialize(lua::lua->get_data_manager().get());
     the_character_db.load_all();
+    the_character_db.freeze();
 }
 
 
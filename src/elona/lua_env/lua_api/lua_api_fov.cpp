@@ -3,6 +3,7 @@
 #include "../../ui.hpp"
 #include "../api_manager.hpp"
 #include "../handle_manager.hpp"
+#include "../interface.hpp"
 
 
 
@@ -80,6 +81,46 @@ void LuaApiFOV::refresh()
     ui_render_non_hud();
 }
 
+namespace
+{
+
+sol::table _to_table(const std::vector<Position>& positions)
+{
+    auto table = lua::create_table();
+    for (size_t i = 0; i < positions.size(); ++i)
+    {
+        table[i + 1] = positions[i];
+    }
+    return table;
+}
+
+} // namespace
+
+/**
+ * @luadoc
+ *
+ * Returns the positions which came into the player's sight at the last
+ * update of the field of view. Checking these instead of every position
+ * on the map is enough to notice whatever the player has just seen.
+ * @treturn table a list of LuaPosition
+ */
+sol::table LuaApiFOV::entered()
+{
+    return _to_table(elona::visible_cells.entered());
+}
+
+/**
+ * @luadoc
+ *
+ * Returns the positions which went out of the player's sight at the last
+ * update of the field of view.
+ * @treturn table a list of LuaPosition
+ */
+sol::table LuaApiFOV::left()
+{
+    return _to_table(elona::visible_cells.left());
+}
+
 void LuaApiFOV::bind(sol::table& api_table)
 {
     api_table.set_function(
@@ -91,6 +132,8 @@ void LuaApiFOV::bind(sol::table& api_table)
             LuaApiFOV::you_see_pos_xy,
             LuaApiFOV::you_see));
     LUA_API_BIND_FUNCTION(api_table, LuaApiFOV, refresh);
+    LUA_API_BIND_FUNCTION(api_table, LuaApiFOV, entered);
+    LUA_API_BIND_FUNCTION(api_table, LuaApiFOV, left);
 }
 
 } // namespace lua
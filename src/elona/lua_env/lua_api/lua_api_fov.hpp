@@ -22,6 +22,9 @@ bool you_see_pos_xy(int, int);
 
 void refresh();
 
+sol::table entered();
+sol::table left();
+
 
 void bind(sol::table&);
 }; // namespace LuaApiFOV
@@ -2,6 +2,7 @@
 #include "../../area.hpp"
 #include "../../character.hpp"
 #include "../../data/types/type_map.hpp"
+#include "../../flow_field.hpp"
 #include "../../lua_env/enums/enums.hpp"
 #include "../../map.hpp"
 #include "../../map_cell.hpp"
@@ -396,6 +397,7 @@ void LuaApiMap::set_tile_xy(int x, int y, int id)
 
     // TODO: check validity of tile ID
     elona::cell_data.at(x, y).chip_id_actual = id;
+    elona::flow_fields.notify_cell_changed(x, y);
 }
 
 /**
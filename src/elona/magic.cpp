@@ -1,4 +1,5 @@
 #include "../util/scope_guard.hpp"
+#include "../util/zone_profiler.hpp"
 #include "ability.hpp"
 #include "activity.hpp"
 #include "animation.hpp"
@@ -18,6 +19,7 @@
 #include "element.hpp"
 #include "elona.hpp"
 #include "enchantment.hpp"
+#include "flow_field.hpp"
 #include "food.hpp"
 #include "fov.hpp"
 #include "i18n.hpp"
@@ -2963,6 +2965,7 @@ bool _magic_457_438()
             }
             cell_data.at(x, y).chip_id_actual = p;
             cell_data.at(x, y).chip_id_memory = p;
+            flow_fields.notify_cell_changed(x, y);
         }
         if (efid == 457)
         {
@@ -2978,6 +2981,7 @@ bool _magic_457_438()
             {
                 cell_data.at(x, y).chip_id_actual = tile_tunnel;
             }
+            flow_fields.notify_cell_changed(x, y);
         }
     }
     else
@@ -3141,6 +3145,7 @@ bool _magic_465()
             }
         }
     }
+    flow_fields.invalidate();
     return true;
 }
 
@@ -4565,6 +4570,8 @@ namespace elona
 
 bool magic()
 {
+    ELONA_PROFILE_ZONE("magic");
+
     int efcibk = ci;
     int fltbk = 0;
     int valuebk = 0;
@@ -1,11 +1,16 @@
 #include "main.hpp"
+#include <random>
+#include "../util/filepathutil.hpp"
 #include "../util/tinyargparser.hpp"
 #include "config.hpp"
 #include "init.hpp"
+#include "input_recorder.hpp"
+#include "log.hpp"
 #include "lua_env/event_manager.hpp"
 #include "lua_env/lua_event/base_event.hpp"
 #include "main_menu.hpp"
 #include "profile/profile_manager.hpp"
+#include "random.hpp"
 #include "turn_sequence.hpp"
 #include "variables.hpp"
 
@@ -20,16 +25,54 @@ tinyargparser::ArgParser _make_argparser()
 {
     return tinyargparser::ArgParser("Elona foobar")
         .add('v', "version", "Show version.")
-        .add('p', "profile", "Specify profile.");
+        .add('p', "profile", "Specify profile.")
+        .add('r', "record", "FILE", "Record the input of the session to FILE.");
 }
 
 
 
+// Where to record the input of the session, if it is to be recorded.
+fs::path _record_file;
+
+
+
+int _make_record_seed()
+{
+    return static_cast<int>(std::random_device{}() & 0x7fffffff);
+}
+
+
+
+// Runs the game from initialize_game() on. Recording starts only for loaded
+// saves, as the record needs a save to start its replay from.
 void _main_loop()
 {
+    const auto record =
+        !_record_file.empty() && mode == 3 &&
+        !config_get_boolean("core.foobar.run_script_in_save");
+    if (!_record_file.empty() && !record)
+    {
+        ELONA_WARN("input") << "Input is recorded only when loading a save.";
+    }
+    const auto seed = _make_record_seed();
+    const auto recorded_player_id = playerid;
+    if (record)
+    {
+        // Replays load the save with the same seed, see simulation::prepare().
+        randomize(seed);
+    }
+
+    initialize_game();
     lua::lua->get_event_manager().trigger(
         lua::BaseEvent("core.game_initialized"));
 
+    if (record)
+    {
+        InputRecorder::instance().start_recording(
+            _record_file, recorded_player_id, seed);
+        randomize(seed);
+    }
+
     while (true)
     {
         bool finished = turn_wrapper();
@@ -38,6 +81,8 @@ void _main_loop()
             break;
         }
     }
+
+    InputRecorder::instance().stop();
 }
 
 
@@ -48,7 +93,6 @@ void _start_elona()
         !config_get_boolean("core.foobar.run_script_in_save"))
     {
         mode = 6;
-        initialize_game();
         _main_loop();
         return;
     }
@@ -76,7 +120,6 @@ void _start_elona()
         {
             playerid = defload;
             mode = 3;
-            initialize_game();
             _main_loop();
             return;
         }
@@ -85,7 +128,6 @@ void _start_elona()
     const auto start = main_menu_loop();
     if (start)
     {
-        initialize_game();
         _main_loop();
     }
 }
@@ -115,6 +157,10 @@ int run(int argc, const char* const* argv)
     }
     const auto profile = args.get_or("profile", profile::default_profile_id);
     profile::ProfileManager::instance().init(profile);
+    if (args.has("record"))
+    {
+        _record_file = filepathutil::u8path(args.get_or("record", ""));
+    }
 
     init();
     _start_elona();
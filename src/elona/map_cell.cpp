@@ -1,4 +1,5 @@
 #include "map_cell.hpp"
+#include "../util/allocation_profiler.hpp"
 #include "character.hpp"
 #include "elona.hpp"
 #include "item.hpp"
@@ -72,6 +73,8 @@ void cell_featclear(int x, int y)
 
 void cell_check(int x, int y)
 {
+    ELONA_ALLOCATION_SCOPE("cell");
+
     cellaccess = 1;
     cellchara = -1;
     cellfeat = -1;
@@ -5,6 +5,7 @@
 #include "ctrl_file.hpp"
 #include "elona.hpp"
 #include "enums.hpp"
+#include "flow_field.hpp"
 #include "i18n.hpp"
 #include "item.hpp"
 #include "itemgen.hpp"
@@ -82,6 +83,7 @@ void map_initialize()
         roomexist(cnt) = 0;
     }
     cell_data.init(map_data.width, map_data.height);
+    flow_fields.invalidate();
     DIM3(mapsync, map_data.width, map_data.height);
     DIM3(mef, 9, MEF_MAX);
     map_tileset(map_data.tileset);
@@ -1848,16 +1850,8 @@ static optional<int> _setup_map_generation_parameters()
     return rdtype;
 }
 
-void generate_random_nefia()
+optional<int> generate_random_nefia_layout(int forced_rdtype)
 {
-    int rdtype = 0;
-    int rdmonsterhouse = 0;
-    int rdcreaturepack = 0;
-    int rdy3 = 0;
-    int rdx3 = 0;
-    int mobdensity = 0;
-    int itemdensity = 0;
-
     while (1)
     {
         randomize();
@@ -1880,10 +1874,10 @@ void generate_random_nefia()
         if (!rdtype_opt)
         {
             // Quest maps can have special generation routines.
-            return;
+            return none;
         }
 
-        rdtype = *rdtype_opt;
+        const auto rdtype = forced_rdtype != 0 ? forced_rdtype : *rdtype_opt;
 
         int stat = 1;
         if (rdtype == 2)
@@ -1910,7 +1904,7 @@ void generate_random_nefia()
         {
             map_data.indoors_flag = 2;
             initialize_random_nefia_rdtype6();
-            return;
+            return none;
         }
         if (rdtype == 8)
         {
@@ -1930,13 +1924,24 @@ void generate_random_nefia()
         }
         if (stat != 0)
         {
-            break;
+            return rdtype;
         }
     }
+}
+
+
+
+void populate_random_nefia(int rdtype)
+{
+    int rdmonsterhouse = 0;
+    int rdcreaturepack = 0;
+    int rdy3 = 0;
+    int rdx3 = 0;
+    int mobdensity = 0;
+    int itemdensity = 0;
+
     map_converttile();
     map_placeplayer();
-    rdmonsterhouse = 0;
-    rdcreaturepack = 0;
     for (int cnt = 0, cnt_end = (roomsum); cnt < cnt_end; ++cnt)
     {
         rx = roomx(cnt) + 1;
@@ -2108,6 +2113,16 @@ void generate_random_nefia()
 
 
 
+void generate_random_nefia()
+{
+    if (const auto rdtype = generate_random_nefia_layout())
+    {
+        populate_random_nefia(*rdtype);
+    }
+}
+
+
+
 void initialize_random_nefia_rdtype6()
 {
     map_initialize();
@@ -3301,6 +3316,16 @@ void mapgen_dig_maze()
 
 
 
+void generate_maze_floor(int maze_class)
+{
+    _mclass = maze_class;
+    _bold = 2;
+    initialize_random_nefia_rdtype9();
+    map_converttile();
+}
+
+
+
 void initialize_random_nefia_rdtype10()
 {
     map_data.width = _mclass * (_bold * 2) - _bold + 8;
@@ -1,5 +1,6 @@
 #pragma once
 #include <string>
+#include "optional.hpp"
 
 namespace elona
 {
@@ -21,6 +22,31 @@ void map_setfog(int = 0, int = 0);
 
 void generate_debug_map();
 void generate_random_nefia();
+
+
+
+/**
+ * The two phases of `generate_random_nefia()`, which runs both, so that each
+ * can be run and measured on its own. The layout (rooms, corridors and
+ * stairs, retried until valid) returns the floor type, which the population
+ * (characters, items and traps) needs, or none if the floor is already
+ * complete, as some quest maps are generated by their own routines. The floor
+ * type is chosen from the area and the dungeon level unless @a rdtype is set.
+ *
+ * Both phases still draw from the global random engine, reseeded by
+ * `randomize()` on every try, and write the global map state (`map_data`,
+ * `cell_data`, `rdtype`, `roomsum`, ...). Neither can run off the game thread
+ * or ahead of time until that state is held by a generator of its own.
+ */
+optional<int> generate_random_nefia_layout(int rdtype = 0);
+void populate_random_nefia(int rdtype);
+
+/**
+ * Generates a maze floor (the same layout as nefia rdtype 9) made of
+ * @a maze_class x @a maze_class maze cells into the current map. No characters
+ * or items are placed.
+ */
+void generate_maze_floor(int maze_class);
 int initialize_quest_map_crop();
 int initialize_random_nefia_rdtype1();
 int initialize_random_nefia_rdtype4();
@@ -1,10 +1,12 @@
 #include "mef.hpp"
+#include "../util/zone_profiler.hpp"
 #include "ability.hpp"
 #include "audio.hpp"
 #include "character.hpp"
 #include "deferred_event.hpp"
 #include "dmgheal.hpp"
 #include "draw.hpp"
+#include "flow_field.hpp"
 #include "fov.hpp"
 #include "i18n.hpp"
 #include "item.hpp"
@@ -122,6 +124,8 @@ void mef_add(
 
 void mef_update()
 {
+    ELONA_PROFILE_ZONE("mef_update");
+
     optional<std::string> sound = none;
     for (int cnt = 0; cnt < MEF_MAX; ++cnt)
     {
@@ -169,6 +173,7 @@ void mef_update()
                         if (chip_data.for_cell(x, y).effect & 4)
                         {
                             cell_data.at(x, y).chip_id_actual = 37;
+                            flow_fields.notify_cell_changed(x, y);
                             cnt = 0 - 1;
                             continue;
                         }
@@ -1,9 +1,13 @@
 #include "message.hpp"
 #include <ctype.h>
+#include <algorithm>
 #include <iomanip>
+#include <iterator>
 #include <sstream>
+#include "../snail/application.hpp"
 #include "../util/range.hpp"
 #include "../util/strutil.hpp"
+#include "../util/zone_profiler.hpp"
 #include "audio.hpp"
 #include "character.hpp"
 #include "config.hpp"
@@ -173,6 +177,149 @@ void Message::clear()
 
 
 
+void Message::flush()
+{
+    if (_draw_ops.empty())
+    {
+        return;
+    }
+
+    ELONA_PROFILE_ZONE("message_flush");
+
+    // Drawing may select another window, which flushes again.
+    std::vector<DrawOp> ops;
+    ops.swap(_draw_ops);
+
+    const auto prev_gmode = current_gmode();
+    auto&& renderer = snail::Application::instance().get_renderer();
+    const auto has_font = renderer.has_font();
+    const auto prev_font_size = has_font ? renderer.font().size() : 0;
+    const auto prev_font_style =
+        has_font ? renderer.font().style() : snail::Font::Style::regular;
+
+    font(14 - en * 2);
+    for (const auto& op : ops)
+    {
+        _draw(op);
+    }
+
+    if (has_font)
+    {
+        font(prev_font_size, prev_font_style);
+    }
+    gmode(prev_gmode.first, prev_gmode.second);
+
+    // Keep the storage for the next frame.
+    ops.clear();
+    if (_draw_ops.empty())
+    {
+        _draw_ops.swap(ops);
+    }
+}
+
+
+
+void Message::set_rendering_enabled(bool enabled)
+{
+    _is_rendering_enabled = enabled;
+    if (!enabled)
+    {
+        _draw_ops.clear();
+    }
+}
+
+
+
+void Message::_queue(DrawOp op)
+{
+    if (!_is_rendering_enabled)
+    {
+        return;
+    }
+
+    if (op.type == DrawOp::Type::scroll)
+    {
+        // Whatever was drawn before the last few scrolls has already left the
+        // window, so it need not be drawn at all.
+        constexpr auto kept_scrolls = inf_msgline + 1;
+        const auto is_scroll = [](const auto& queued) {
+            return queued.type == DrawOp::Type::scroll;
+        };
+        if (range::count_if(_draw_ops, is_scroll) >= kept_scrolls)
+        {
+            const auto first = range::find_if(_draw_ops, is_scroll);
+            _draw_ops.erase(
+                std::begin(_draw_ops),
+                std::find_if(std::next(first), std::end(_draw_ops), is_scroll));
+        }
+    }
+    else if (!_draw_ops.empty() && _draw_ops.back() == op)
+    {
+        // The same message again at the same place.
+        return;
+    }
+
+    _draw_ops.push_back(std::move(op));
+}
+
+
+
+void Message::_draw(const DrawOp& op)
+{
+    const auto chunks = (windoww - inf_msgx) / 192;
+    const auto chunk_width = [&](int i) {
+        return i == chunks ? (windoww - inf_msgx) % 192 : 192;
+    };
+
+    switch (op.type)
+    {
+    case DrawOp::Type::scroll:
+        gmode(0);
+        gcopy(
+            0,
+            inf_msgx,
+            inf_msgy + 5 + inf_msgspace,
+            windoww - inf_msgx,
+            inf_msgspace * 3 + en * 3,
+            inf_msgx,
+            inf_msgy + 5);
+        for (int i = 0; i < chunks + 1; ++i)
+        {
+            draw_region(
+                "message_window_contents",
+                i * 192 + inf_msgx,
+                inf_msgy + 5 + inf_msgspace * 3 + en * 2,
+                0,
+                op.param * inf_msgspace,
+                chunk_width(i),
+                inf_msgspace);
+        }
+        break;
+    case DrawOp::Type::transparency:
+        gmode(2, op.param);
+        for (int i = 0; i < chunks + 1; ++i)
+        {
+            draw_region(
+                "message_window_contents",
+                i * 192 + inf_msgx,
+                inf_msgy + 5,
+                chunk_width(i),
+                inf_msgspace * 3);
+        }
+        break;
+    case DrawOp::Type::symbol:
+        gmode(2);
+        draw_indexed("message_symbol", op.x, op.y, op.param);
+        break;
+    case DrawOp::Type::text:
+        gmode(0);
+        mes(op.x, op.y, op.text, op.color);
+        break;
+    }
+}
+
+
+
 void Message::_msg_write(std::string& message)
 {
     constexpr const auto musical_note = u8"♪";
@@ -195,19 +342,23 @@ void Message::_msg_write(std::string& message)
                 bytewise_pos + std::strlen(musical_note) + (symbol_type != 0));
 
         gmode(2);
-        draw_indexed(
-            "message_symbol",
-            (message_width + widthwise_pos) * 7 + inf_msgx + 7 + en * 3,
-            (inf_msgline - 1) * inf_msgspace + inf_msgy + 5,
-            symbol_type * 2);
+        _queue({DrawOp::Type::symbol,
+                static_cast<int>(message_width + widthwise_pos) * 7 +
+                    inf_msgx + 7 + en * 3,
+                (inf_msgline - 1) * inf_msgspace + inf_msgy + 5,
+                symbol_type * 2,
+                "",
+                text_color});
     }
 
     font(14 - en * 2);
     gmode(0);
-    mes(message_width * 7 + inf_msgx + 6,
-        (inf_msgline - 1) * inf_msgspace + inf_msgy + vfix + 5,
-        message,
-        text_color);
+    _queue({DrawOp::Type::text,
+            static_cast<int>(message_width) * 7 + inf_msgx + 6,
+            (inf_msgline - 1) * inf_msgspace + inf_msgy + vfix + 5,
+            0,
+            message,
+            text_color});
 
     message_log.append(message, text_color);
 }
@@ -227,37 +378,7 @@ void Message::_msg_newline()
     msg[msgline % inf_maxlog] = "";
 
     gmode(0);
-    gcopy(
-        0,
-        inf_msgx,
-        inf_msgy + 5 + inf_msgspace,
-        windoww - inf_msgx,
-        inf_msgspace * 3 + en * 3,
-        inf_msgx,
-        inf_msgy + 5);
-
-    int p_at_txtfunc = (windoww - inf_msgx) / 192;
-    for (int cnt = 0, cnt_end = (p_at_txtfunc + 1); cnt < cnt_end; ++cnt)
-    {
-        int x_at_txtfunc;
-        if (cnt == p_at_txtfunc)
-        {
-            x_at_txtfunc = (windoww - inf_msgx) % 192;
-        }
-        else
-        {
-            x_at_txtfunc = 192;
-        }
-        draw_region(
-            "message_window_contents",
-            cnt * 192 + inf_msgx,
-            inf_msgy + 5 + inf_msgspace * 3 + en * 2,
-            0,
-            msgline % 4 * inf_msgspace,
-            x_at_txtfunc,
-            inf_msgspace);
-    }
-
+    _queue({DrawOp::Type::scroll, 0, 0, msgline % 4, "", text_color});
     gmode(2);
     msgtempprev.clear();
 }
@@ -285,26 +406,9 @@ void Message::_txt_conv()
         _new_turn = false;
         if (g_config.message_transparency())
         {
-            int p_at_txtfunc = (windoww - inf_msgx) / 192;
-            gmode(2, g_config.message_transparency() * 20);
-            for (int i = 0; i < p_at_txtfunc + 1; ++i)
-            {
-                int x_at_txtfunc;
-                if (i == p_at_txtfunc)
-                {
-                    x_at_txtfunc = (windoww - inf_msgx) % 192;
-                }
-                else
-                {
-                    x_at_txtfunc = 192;
-                }
-                draw_region(
-                    "message_window_contents",
-                    i * 192 + inf_msgx,
-                    inf_msgy + 5,
-                    x_at_txtfunc,
-                    inf_msgspace * 3);
-            }
+            const auto alpha = g_config.message_transparency() * 20;
+            gmode(2, alpha);
+            _queue({DrawOp::Type::transparency, 0, 0, alpha, "", text_color});
         }
         if (g_config.message_add_timestamps())
         {
@@ -103,8 +103,55 @@ public:
     void buffered_message_end();
 
 
+    /**
+     * Messages are laid out as soon as txt() is called, but drawn into the
+     * message window only here. It is called before the screen is presented
+     * or another window is selected, so game logic never has to.
+     */
+    void flush();
+
+
+    /**
+     * Disables drawing messages entirely, for headless runs. The layout and
+     * the message log are kept up to date either way.
+     */
+    void set_rendering_enabled(bool enabled);
+
+
+    size_t pending_draw_count() const
+    {
+        return _draw_ops.size();
+    }
+
+
 
 private:
+    struct DrawOp
+    {
+        enum class Type
+        {
+            scroll, // Scrolls the window up by one line; `param` is the row.
+            transparency, // `param` is the alpha.
+            symbol, // `param` is the symbol type.
+            text,
+        };
+
+        Type type;
+        int x;
+        int y;
+        int param;
+        std::string text;
+        snail::Color color;
+
+        bool operator==(const DrawOp& other) const
+        {
+            return type == other.type && x == other.x && y == other.y &&
+                param == other.param && text == other.text &&
+                color == other.color;
+        }
+    };
+
+
     bool show_only_once{};
     bool _continue_sentence{};
     snail::Color text_color{255, 255, 255};
@@ -114,6 +161,8 @@ private:
     std::vector<std::string> msg{500 /* TODO inf_maxlog */};
     std::string msgtemp;
     std::string msgtempprev;
+    std::vector<DrawOp> _draw_ops;
+    bool _is_rendering_enabled = true;
 
 
 
@@ -147,6 +196,8 @@ private:
 
 
 
+    void _queue(DrawOp op);
+    void _draw(const DrawOp& op);
     void _msg_write(std::string& message);
     void _msg_newline();
     void _txt_conv();
@@ -1,10 +1,12 @@
 #include "net.hpp"
+#include <atomic>
 #include <chrono>
 #include <sstream>
 #include "../spider/http.hpp"
 #include "../thirdparty/json5/json5.hpp"
 #include "../thirdparty/xxHash/xxhashcpp.hpp"
 #include "../util/scope_guard.hpp"
+#include "../util/spsc_queue.hpp"
 #include "config.hpp"
 #include "i18n.hpp"
 #include "input.hpp"
@@ -56,14 +58,29 @@ int last_received_chat_id = -1;
 
 
 
-Headers common_headers_get{{"Connection", "close"},
+Headers common_headers_get{{"Connection", "keep-alive"},
                            {"User-Agent", latest_version.user_agent()}};
-Headers common_headers_post{{"Connection", "close"},
+Headers common_headers_post{{"Connection", "keep-alive"},
                             {"User-Agent", latest_version.user_agent()},
                             {"Content-Type", "application/json"}};
 
 
 
+// Chats fetched in the background. Response handlers run on the network
+// thread, so they only parse the response; filtering and reporting errors
+// touch the config and the message log and are left to the game thread.
+struct ChatFetchResult
+{
+    bool ok = false;
+    std::vector<ChatData> chats;
+    std::string error; // If not ok.
+};
+
+lib::SpscQueue<ChatFetchResult, 4> fetched_chats;
+std::atomic<bool> is_fetching_chats{false};
+
+
+
 Duration chat_receive_interval()
 {
     return std::chrono::minutes{
@@ -178,22 +195,139 @@ std::string get_date()
     return ss.str();
 }
 
-} // namespace
 
 
+std::vector<ChatData> parse_chats(const std::string& body)
+{
+    std::vector<ChatData> chats;
 
-std::vector<ChatData> net_receive_chats(bool skip_old_chat)
+    const auto& chats_json = json5::parse(body);
+    for (const auto& chat_json : chats_json.get_array())
+    {
+        const auto& chat = chat_json.get_object();
+        chats.emplace_back(
+            chat.find("id")->second.get_integer(),
+            static_cast<ChatKind>(chat.find("kind")->second.get_integer()),
+            chat.find("created_at")->second.get_string(),
+            chat.find("message")->second.get_string());
+    }
+
+    return chats;
+}
+
+
+
+std::vector<ChatData> filter_chats(
+    std::vector<ChatData> chats,
+    bool skip_old_chat)
 {
-    if (!g_config.net())
+    std::vector<ChatData> ret;
+
+    for (auto&& chat : chats)
     {
-        return {};
+        if (chat.id <= last_received_chat_id)
+        {
+            if (skip_old_chat)
+            {
+                continue;
+            }
+        }
+        else
+        {
+            last_received_chat_id = chat.id;
+        }
+
+        switch (chat.kind)
+        {
+        case ChatKind::chat:
+            if (config_get_string("core.net.chat") == "disabled")
+            {
+                continue;
+            }
+        case ChatKind::death:
+            if (config_get_string("core.net.death") == "disabled")
+            {
+                continue;
+            }
+        case ChatKind::wish:
+            if (config_get_string("core.net.wish") == "disabled")
+            {
+                continue;
+            }
+        case ChatKind::news:
+            if (config_get_string("core.net.news") == "disabled")
+            {
+                continue;
+            }
+        default: break;
+        }
+
+        ret.push_back(std::move(chat));
     }
-    if (skip_old_chat &&
-        Clock::now() - last_chat_received_at < chat_receive_interval())
+
+    return ret;
+}
+
+
+
+void fetch_chats_in_background()
+{
+    if (is_fetching_chats.exchange(true))
     {
-        return {};
+        return;
+    }
+
+    const auto finish = [](ChatFetchResult result) {
+        // Only one fetch is in flight at a time, so the queue cannot be full
+        // unless the game thread stopped draining it.
+        fetched_chats.push(std::move(result));
+        is_fetching_chats = false;
+    };
+
+    Request req{Verb::GET, chat_url, common_headers_get};
+    try
+    {
+        req.send(
+            [=](const auto& response) {
+                ChatFetchResult result;
+                if (response.status / 100 != 2)
+                {
+                    result.error = chat_url + " " +
+                        std::to_string(response.status) + " " + response.body;
+                }
+                else
+                {
+                    try
+                    {
+                        result.chats = parse_chats(response.body);
+                        result.ok = true;
+                    }
+                    catch (const std::exception& e)
+                    {
+                        result.error = chat_url + " " + e.what();
+                    }
+                }
+                finish(std::move(result));
+            },
+            [=](const auto& error) {
+                ChatFetchResult result;
+                result.error = error.what();
+                finish(std::move(result));
+            });
+    }
+    catch (const std::exception& e)
+    {
+        // No handler will run, so the next turn may fetch again.
+        ChatFetchResult result;
+        result.error = chat_url + " " + e.what();
+        finish(std::move(result));
     }
+}
+
+
 
+std::vector<ChatData> receive_chats_now()
+{
     bool done = false;
     std::vector<ChatData> chats;
 
@@ -209,55 +343,7 @@ std::vector<ChatData> net_receive_chats(bool skip_old_chat)
                 return;
             }
 
-            const auto& chats_json = json5::parse(response.body);
-            for (const auto& chat_json : chats_json.get_array())
-            {
-                const auto& chat = chat_json.get_object();
-                auto kind = chat.find("kind")->second.get_integer();
-                auto id = chat.find("id")->second.get_integer();
-                if (id <= last_received_chat_id)
-                {
-                    if (skip_old_chat)
-                    {
-                        continue;
-                    }
-                }
-                else
-                {
-                    last_received_chat_id = id;
-                }
-
-                switch (static_cast<ChatKind>(kind))
-                {
-                case ChatKind::chat:
-                    if (config_get_string("core.net.chat") == "disabled")
-                    {
-                        continue;
-                    }
-                case ChatKind::death:
-                    if (config_get_string("core.net.death") == "disabled")
-                    {
-                        continue;
-                    }
-                case ChatKind::wish:
-                    if (config_get_string("core.net.wish") == "disabled")
-                    {
-                        continue;
-                    }
-                case ChatKind::news:
-                    if (config_get_string("core.net.news") == "disabled")
-                    {
-                        continue;
-                    }
-                default: break;
-                }
-
-                chats.emplace_back(
-                    id,
-                    static_cast<ChatKind>(kind),
-                    chat.find("created_at")->second.get_string(),
-                    chat.find("message")->second.get_string());
-            }
+            chats = parse_chats(response.body);
             done = true;
         },
         [&](const auto& error) {
@@ -272,7 +358,52 @@ std::vector<ChatData> net_receive_chats(bool skip_old_chat)
         await(10);
     }
 
-    last_chat_received_at = Clock::now();
+    return filter_chats(std::move(chats), false);
+}
+
+} // namespace
+
+
+
+std::vector<ChatData> net_receive_chats(bool skip_old_chat)
+{
+    if (!g_config.net())
+    {
+        return {};
+    }
+    if (!skip_old_chat)
+    {
+        // The chat history asks for the whole log and waits for it.
+        last_chat_received_at = Clock::now();
+        return receive_chats_now();
+    }
+
+    // Called every turn, so never wait for the server: take what the last
+    // background fetch brought and start the next one when it is due.
+    std::vector<ChatData> chats;
+    while (auto result = fetched_chats.pop())
+    {
+        if (!result->ok)
+        {
+            txt(i18n::s.get("core.net.failed_to_receive"));
+            ELONA_WARN("net.get") << result->error;
+            continue;
+        }
+        for (auto&& chat : filter_chats(std::move(result->chats), true))
+        {
+            chats.push_back(std::move(chat));
+        }
+    }
+
+    // The steady clock may start at boot, so do not wait for the interval
+    // before the first fetch.
+    if (last_chat_received_at == TimePoint{} ||
+        Clock::now() - last_chat_received_at >= chat_receive_interval())
+    {
+        last_chat_received_at = Clock::now();
+        fetch_chats_in_background();
+    }
+
     return chats;
 }
 
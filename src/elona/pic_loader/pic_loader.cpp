@@ -1,8 +1,15 @@
 #include "pic_loader.hpp"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <future>
+#include <thread>
 #include "../../snail/application.hpp"
 #include "../../snail/color.hpp"
+#include "../../snail/surface.hpp"
 #include "../elona.hpp"
 #include "../hcl.hpp"
+#include "../log.hpp"
 
 
 
@@ -12,6 +19,55 @@ namespace
 constexpr int _displayed_portrait_width = 80;
 constexpr int _displayed_portrait_height = 112;
 
+constexpr unsigned _max_decoding_threads = 8;
+
+// Bump it whenever the layout file format or the packing changes.
+constexpr int _layout_version = 1;
+
+
+
+using Clock = std::chrono::steady_clock;
+
+double _seconds_since(Clock::time_point start)
+{
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+
+
+std::vector<optional<snail::Surface>> _decode_images(
+    const std::vector<PicLoader::LoadRequest>& requests)
+{
+    std::vector<optional<snail::Surface>> surfaces(requests.size());
+    const auto thread_count = std::min<size_t>(
+        requests.size(),
+        std::max(
+            1u,
+            std::min(
+                std::thread::hardware_concurrency(), _max_decoding_threads)));
+
+    // Each thread decodes every `thread_count`-th image into its own slots.
+    // Destroying a future from std::async waits for its thread, so the
+    // threads are done with `surfaces` even if one of them throws.
+    std::vector<std::future<void>> threads;
+    for (size_t t = 0; t < thread_count; ++t)
+    {
+        threads.push_back(std::async(std::launch::async, [&, t]() {
+            for (size_t i = t; i < requests.size(); i += thread_count)
+            {
+                surfaces[i] = snail::Surface{requests[i].image_file,
+                                             snail::Color{0, 0, 0}};
+            }
+        }));
+    }
+    for (auto& thread : threads)
+    {
+        thread.get();
+    }
+
+    return surfaces;
+}
+
 
 
 static void copy_image(snail::Image& img, const Extent& ext)
@@ -79,6 +135,12 @@ void PicLoader::clear()
 
     buffers.clear();
     storage.clear();
+    elapsed = {};
+
+    cached.clear();
+    cached_used = 0;
+    is_layout_restored = false;
+    is_layout_stale = false;
 }
 
 std::pair<Extent, size_t> PicLoader::find_extent(
@@ -155,7 +217,52 @@ void PicLoader::load(
     const IdType& id,
     PageType type)
 {
-    snail::Image img{image_file, snail::Color{0, 0, 0}};
+    const auto decode_start = Clock::now();
+    snail::Surface surface{image_file, snail::Color{0, 0, 0}};
+    elapsed.decode += _seconds_since(decode_start);
+
+    const auto upload_start = Clock::now();
+    snail::Image img{surface};
+    elapsed.upload += _seconds_since(upload_start);
+
+    load_image(img, id, type);
+}
+
+void PicLoader::load(const std::vector<LoadRequest>& requests)
+{
+    if (requests.empty())
+    {
+        return;
+    }
+
+    const auto before = elapsed;
+
+    const auto decode_start = Clock::now();
+    auto surfaces = _decode_images(requests);
+    elapsed.decode += _seconds_since(decode_start);
+
+    for (size_t i = 0; i < requests.size(); ++i)
+    {
+        const auto upload_start = Clock::now();
+        snail::Image img{*surfaces[i]};
+        surfaces[i] = none;
+        elapsed.upload += _seconds_since(upload_start);
+
+        load_image(img, requests[i].id, requests[i].type);
+    }
+
+    ELONA_LOG("draw") << "Loaded " << requests.size() << " sprites in "
+                      << (elapsed.decode - before.decode) * 1000
+                      << " ms decoding, "
+                      << (elapsed.pack - before.pack) * 1000
+                      << " ms packing and "
+                      << (elapsed.upload - before.upload) * 1000
+                      << " ms uploading.";
+}
+
+void PicLoader::load_image(snail::Image& img, const IdType& id, PageType type)
+{
+    const auto pack_start = Clock::now();
     Extent ext{0, 0, 0, 0};
 
     auto it = storage.find(id);
@@ -163,6 +270,12 @@ void PicLoader::load(
     {
         ext = it->second;
     }
+    else if (
+        const auto cached_ext =
+            take_cached_extent(id, type, img.width(), img.height()))
+    {
+        ext = *cached_ext;
+    }
     else
     {
         size_t info_index = 0;
@@ -174,11 +287,14 @@ void PicLoader::load(
         auto& info = buffers.at(info_index);
         info.insert_extent(skyline_index, ext);
     }
+    elapsed.pack += _seconds_since(pack_start);
 
     // Render the sprite to the region of the buffer that was found.
+    const auto upload_start = Clock::now();
     gsel(ext.buffer);
 
     copy_image(img, ext);
+    elapsed.upload += _seconds_since(upload_start);
 
     // Store the buffer region for later lookup.
     storage[id] = ext;
@@ -189,7 +305,22 @@ void PicLoader::add_predefined_extents(
     const MapType& extents,
     PageType type)
 {
-    snail::Image img{atlas_file, snail::Color{0, 0, 0}};
+    const auto decode_start = Clock::now();
+    snail::Surface surface{atlas_file, snail::Color{0, 0, 0}};
+    elapsed.decode += _seconds_since(decode_start);
+
+    const auto upload_start = Clock::now();
+    snail::Image img{surface};
+    elapsed.upload += _seconds_since(upload_start);
+
+    add_predefined_extents(img, extents, type);
+}
+
+void PicLoader::add_predefined_extents(
+    snail::Image& img,
+    const MapType& extents,
+    PageType type)
+{
 
     // Add a new buffer for this atlas. The assumption is that all the
     // defined sprites will fit on this buffer. This assumption might
@@ -200,32 +331,42 @@ void PicLoader::add_predefined_extents(
     size_t info_index = 0;
     for (auto& pair : extents)
     {
+        const auto pack_start = Clock::now();
+
         // Get the source loaded from a definition file.
         const Extent& source = pair.second;
         Extent dest{0, 0, 0, 0};
 
+        // FIXME: refactor this dirty hack.
+        int width = source.width;
+        int height = source.height;
+        if (type == PageType::portrait)
+        {
+            width = _displayed_portrait_width;
+            height = _displayed_portrait_height;
+        }
+
         auto it = storage.find(pair.first);
         if (it != storage.end())
         {
             dest = it->second;
             info_index = dest.buffer - max_buffers;
         }
+        else if (
+            const auto cached_ext =
+                take_cached_extent(pair.first, type, width, height))
+        {
+            dest = *cached_ext;
+            dest.frame_width = source.frame_width;
+            info_index = dest.buffer - max_buffers;
+            storage[pair.first] = dest;
+        }
         else
         {
             assert(source.right() < img.width());
             assert(source.bottom() < img.height());
 
             // Find a region on a buffer to place the sprite.
-
-            // FIXME: refactor this dirty hack.
-            int width = source.width;
-            int height = source.height;
-            if (type == PageType::portrait)
-            {
-                width = _displayed_portrait_width;
-                height = _displayed_portrait_height;
-            }
-
             size_t skyline_index;
             std::tie(dest, skyline_index) = find_extent(
                 width, height, type, info_index, img.width(), img.height());
@@ -238,7 +379,9 @@ void PicLoader::add_predefined_extents(
             // Store the buffer region for later lookup.
             storage[pair.first] = dest;
         }
+        elapsed.pack += _seconds_since(pack_start);
 
+        const auto upload_start = Clock::now();
         gsel(dest.buffer);
 
         // Render the defined portion of the image onto the buffer.
@@ -250,9 +393,176 @@ void PicLoader::add_predefined_extents(
         {
             copy_image_cropped(img, source, dest);
         }
+        elapsed.upload += _seconds_since(upload_start);
     }
 }
 
+void PicLoader::restore_layout(const fs::path& layout_file)
+{
+    assert(buffers.empty());
+
+    std::ifstream in{layout_file.native()};
+    if (!in)
+    {
+        return;
+    }
+
+    // Read everything first, so that a broken file changes nothing.
+    std::string tag;
+    int version;
+    size_t buffer_count;
+    if (!(in >> tag >> version >> buffer_count) || tag != "pic_layout" ||
+        version != _layout_version ||
+        buffer_count > static_cast<size_t>(max_buffers))
+    {
+        ELONA_WARN("draw") << "Ignoring outdated sprite layout "
+                           << layout_file.string();
+        return;
+    }
+
+    std::vector<BufferInfo> new_buffers;
+    for (size_t i = 0; i < buffer_count; ++i)
+    {
+        int type;
+        int width;
+        int height;
+        size_t skyline_count;
+        if (!(in >> tag >> type >> width >> height >> skyline_count) ||
+            tag != "buffer" || type < 0 ||
+            type > static_cast<int>(PageType::map_feat) || width <= 0 ||
+            height <= 0)
+        {
+            ELONA_WARN("draw") << "Ignoring broken sprite layout "
+                               << layout_file.string();
+            return;
+        }
+
+        std::vector<Skyline> skylines;
+        for (size_t j = 0; j < skyline_count; ++j)
+        {
+            int x;
+            int y;
+            int skyline_width;
+            if (!(in >> x >> y >> skyline_width))
+            {
+                ELONA_WARN("draw") << "Ignoring broken sprite layout "
+                                   << layout_file.string();
+                return;
+            }
+            skylines.emplace_back(x, y, skyline_width);
+        }
+
+        new_buffers.emplace_back(
+            static_cast<PageType>(type),
+            max_buffers + static_cast<int>(i),
+            width,
+            height);
+        new_buffers.back().set_skylines(std::move(skylines));
+    }
+
+    std::unordered_map<IdType, Extent> new_cached;
+    std::string id;
+    Extent ext;
+    while (in >> tag >> id >> ext.buffer >> ext.x >> ext.y >> ext.width >>
+           ext.height >> ext.frame_width)
+    {
+        const auto buffer_index = ext.buffer - max_buffers;
+        if (tag != "extent" || buffer_index < 0 ||
+            buffer_index >= static_cast<int>(new_buffers.size()))
+        {
+            ELONA_WARN("draw") << "Ignoring broken sprite layout "
+                               << layout_file.string();
+            return;
+        }
+        new_cached[SharedId(id)] = ext;
+    }
+
+    for (const auto& info : new_buffers)
+    {
+        add_buffer(info.type, info.width, info.height)
+            .set_skylines(info.get_skylines());
+    }
+    cached = std::move(new_cached);
+    is_layout_restored = true;
+
+    ELONA_LOG("draw") << "Restored the layout of " << cached.size()
+                      << " sprites in " << buffers.size() << " buffers.";
+}
+
+void PicLoader::save_layout(const fs::path& layout_file) const
+{
+    if (is_layout_restored)
+    {
+        if (!is_layout_stale && cached_used == cached.size())
+        {
+            // The file already holds this layout.
+            return;
+        }
+
+        ELONA_LOG("draw") << "The sprite layout changed; it will be packed "
+                             "again on the next launch.";
+        if (fs::exists(layout_file))
+        {
+            fs::remove(layout_file);
+        }
+        return;
+    }
+
+    std::ofstream out{layout_file.native()};
+    if (!out)
+    {
+        ELONA_WARN("draw") << "Cannot save the sprite layout to "
+                           << layout_file.string();
+        return;
+    }
+
+    out << "pic_layout " << _layout_version << " " << buffers.size() << "\n";
+    for (const auto& info : buffers)
+    {
+        const auto& skylines = info.get_skylines();
+        out << "buffer " << static_cast<int>(info.type) << " " << info.width
+            << " " << info.height << " " << skylines.size() << "\n";
+        for (const auto& skyline : skylines)
+        {
+            out << skyline.x << " " << skyline.y << " " << skyline.width
+                << "\n";
+        }
+    }
+    for (const auto& pair : storage)
+    {
+        const auto& ext = pair.second;
+        out << "extent " << pair.first.get() << " " << ext.buffer << " "
+            << ext.x << " " << ext.y << " " << ext.width << " " << ext.height
+            << " " << ext.frame_width << "\n";
+    }
+}
+
+optional<Extent> PicLoader::take_cached_extent(
+    const IdType& id,
+    PageType type,
+    int width,
+    int height)
+{
+    if (!is_layout_restored)
+    {
+        return none;
+    }
+
+    // Only the size of a sprite matters for the layout; its pixels are
+    // copied again anyway.
+    const auto it = cached.find(id);
+    if (it == cached.end() ||
+        buffers.at(it->second.buffer - max_buffers).type != type ||
+        it->second.width != width || it->second.height != height)
+    {
+        is_layout_stale = true;
+        return none;
+    }
+
+    ++cached_used;
+    return it->second;
+}
+
 PicLoader::BufferInfo& PicLoader::add_buffer(PageType type, int w, int h)
 {
     int new_buffer_index;
@@ -1,6 +1,9 @@
 #pragma once
 #include <cassert>
 #include <climits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 #include "../../snail/image.hpp"
 #include "../../thirdparty/ordered_map/ordered_map.h"
 #include "../../util/noncopyable.hpp"
@@ -175,6 +178,16 @@ public:
             }
         }
 
+        const std::vector<Skyline>& get_skylines() const
+        {
+            return skylines;
+        }
+
+        void set_skylines(std::vector<Skyline> new_skylines)
+        {
+            skylines = std::move(new_skylines);
+        }
+
     private:
         void merge_all()
         {
@@ -243,6 +256,24 @@ public:
     using IdType = SharedId;
     using MapType = tsl::ordered_map<IdType, Extent>;
 
+    struct LoadRequest
+    {
+        fs::path image_file;
+        IdType id;
+        PageType type;
+    };
+
+    /***
+     * Time spent loading sprites since the last clear(), in seconds.
+     * Decoding is wall-clock time of the worker threads.
+     */
+    struct Timings
+    {
+        double decode = 0;
+        double pack = 0;
+        double upload = 0;
+    };
+
     void clear();
 
     /***
@@ -251,6 +282,14 @@ public:
      */
     void load(const fs::path&, const IdType&, PageType);
 
+    /***
+     * Loads many sprites as if by calling load() for each of them in
+     * order. The images are decoded on worker threads; packing them
+     * and copying them to the buffers happens on the main thread, so
+     * the layout does not depend on which image finishes first.
+     */
+    void load(const std::vector<LoadRequest>&);
+
     /***
      * Loads a map of rectangular extents indexed by an ID
      * ("core.chara_sprite.<xxx>", etc.) using a map file.
@@ -264,6 +303,24 @@ public:
      * insertions.
      */
     void add_predefined_extents(const fs::path&, const MapType&, PageType);
+    void add_predefined_extents(snail::Image&, const MapType&, PageType);
+
+    /***
+     * Restores the layout saved by save_layout() on an earlier launch.
+     * Sprites loaded afterwards take their old place without packing
+     * if it has the same type and size; the others are packed into
+     * the space left over. The images are still copied every time, so
+     * changed pixels show up regardless. Call it right after clear().
+     */
+    void restore_layout(const fs::path&);
+
+    /***
+     * Saves the current layout for restore_layout(). If a restored
+     * layout did not match the loaded sprites exactly, removes the file
+     * instead, so that the next launch packs from scratch rather than
+     * keeping the holes left by sprites that moved or went away.
+     */
+    void save_layout(const fs::path&) const;
 
     optional_ref<const Extent> operator[](const IdType& id) const
     {
@@ -279,6 +336,11 @@ public:
         return (*this)[SharedId(inner_id)];
     }
 
+    const Timings& timings() const
+    {
+        return elapsed;
+    }
+
     std::vector<int> get_buffers_of_type(PageType type)
     {
         std::vector<int> result;
@@ -301,9 +363,18 @@ private:
     BufferInfo& add_buffer(PageType, int, int);
     std::pair<Extent, size_t>
     find_extent(int, int, PicLoader::PageType, size_t&, int, int);
+    void load_image(snail::Image&, const IdType&, PageType);
+    optional<Extent> take_cached_extent(const IdType&, PageType, int, int);
 
     std::vector<BufferInfo> buffers;
     MapType storage;
+    Timings elapsed;
+
+    // The layout restored by restore_layout().
+    std::unordered_map<IdType, Extent> cached;
+    size_t cached_used = 0;
+    bool is_layout_restored = false;
+    bool is_layout_stale = false;
 };
 
 
@@ -7,6 +7,7 @@
 #include "i18n.hpp"
 #include "lua_env/lua_env.hpp"
 #include "putit.hpp"
+#include "save_stream.hpp"
 #include "save_update.hpp"
 #include "ui.hpp"
 
@@ -83,8 +84,7 @@ void load_save_data()
         int minor;
         int patch;
         {
-            std::ifstream in{(save_dir / "foobar_data.s1").native(),
-                             std::ios::binary};
+            SaveIFStream in{save_dir / "foobar_data.s1"};
             putit::BinaryIArchive ar{in};
             ar(major);
             ar(minor);
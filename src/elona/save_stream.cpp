@@ -0,0 +1,144 @@
+#include "save_stream.hpp"
+#include <algorithm>
+#include "../thirdparty/zstr/zstr.hpp"
+
+
+
+namespace
+{
+
+// Chosen like PNG's signature: the high byte and the line endings make it
+// unlikely to be the start of an uncompressed save file.
+constexpr char _magic[] = {'\x89', 'E', 'F', 'Z', '\r', '\n', '\x1a', '\n'};
+
+constexpr size_t _buffer_size = 64 * 1024;
+
+// Saving happens while the player waits. Most of the data is runs of zeros,
+// which the fastest level already compresses well.
+constexpr int _compression_level = Z_BEST_SPEED;
+
+} // namespace
+
+
+
+namespace elona
+{
+
+// Passes the compressed data on to the file and remembers whether any of it
+// could not be written. zstr ignores that when it finishes the stream in its
+// destructor. It only writes through sputn().
+class SaveOFStream::Sink : public std::streambuf
+{
+public:
+    explicit Sink(std::streambuf* file)
+        : _file(file)
+    {
+    }
+
+    bool has_failed() const
+    {
+        return _has_failed;
+    }
+
+protected:
+    std::streamsize xsputn(const char* data, std::streamsize size) override
+    {
+        const auto written = _file->sputn(data, size);
+        if (written != size)
+        {
+            _has_failed = true;
+        }
+        return written;
+    }
+
+    int sync() override
+    {
+        return _file->pubsync();
+    }
+
+private:
+    std::streambuf* _file;
+    bool _has_failed = false;
+};
+
+
+
+SaveIFStream::SaveIFStream(const fs::path& filepath)
+    : std::istream(nullptr)
+    , _file(filepath.native(), std::ios::binary)
+{
+    char magic[sizeof(_magic)];
+    _file.read(magic, sizeof(magic));
+    if (_file.gcount() == static_cast<std::streamsize>(sizeof(_magic)) &&
+        std::equal(std::begin(magic), std::end(magic), std::begin(_magic)))
+    {
+        _inflater = std::make_unique<zstr::istreambuf>(
+            _file.rdbuf(), _buffer_size, false);
+        rdbuf(_inflater.get());
+        return;
+    }
+
+    const auto is_open = _file.is_open();
+    _file.clear();
+    _file.seekg(0);
+    rdbuf(_file.rdbuf());
+    if (!is_open)
+    {
+        setstate(std::ios::failbit);
+    }
+}
+
+
+
+SaveIFStream::~SaveIFStream() = default;
+
+
+
+SaveOFStream::SaveOFStream(const fs::path& filepath)
+    : std::ostream(nullptr)
+    , _file(filepath.native(), std::ios::binary)
+{
+    if (!_file.write(_magic, sizeof(_magic)))
+    {
+        rdbuf(_file.rdbuf());
+        setstate(std::ios::failbit);
+        return;
+    }
+
+    _sink = std::make_unique<Sink>(_file.rdbuf());
+    _deflater = std::make_unique<zstr::ostreambuf>(
+        _sink.get(), _buffer_size, _compression_level);
+    rdbuf(_deflater.get());
+}
+
+
+
+// Destroying the deflater finishes the zlib stream before the file is closed.
+SaveOFStream::~SaveOFStream()
+{
+    _deflater.reset();
+}
+
+
+
+void SaveOFStream::close()
+{
+    if (!_file.is_open())
+    {
+        return;
+    }
+
+    // rdbuf() clears the state, so it is read first.
+    auto failed = fail();
+    rdbuf(_file.rdbuf());
+    _deflater.reset();
+    failed = failed || (_sink && _sink->has_failed());
+    _sink.reset();
+    _file.close();
+    if (failed || _file.fail())
+    {
+        setstate(std::ios::failbit);
+    }
+}
+
+} // namespace elona
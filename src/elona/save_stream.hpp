@@ -0,0 +1,70 @@
+#pragma once
+
+#include <fstream>
+#include <istream>
+#include <memory>
+#include <ostream>
+#include "filesystem.hpp"
+
+
+
+namespace zstr
+{
+class istreambuf;
+class ostreambuf;
+} // namespace zstr
+
+
+
+namespace elona
+{
+
+/**
+ * Reads a save file written by SaveOFStream. Files written by older versions,
+ * which are not compressed, are read as they are.
+ */
+class SaveIFStream : public std::istream
+{
+public:
+    explicit SaveIFStream(const fs::path& filepath);
+    ~SaveIFStream();
+
+    bool is_compressed() const
+    {
+        return static_cast<bool>(_inflater);
+    }
+
+private:
+    std::ifstream _file;
+    std::unique_ptr<zstr::istreambuf> _inflater;
+};
+
+
+
+/**
+ * Writes a save file compressed with zlib. The file starts with a magic, so
+ * that SaveIFStream can tell it from the uncompressed files of older versions.
+ * Most of the data is zero-filled slots of empty characters and items, which
+ * shrinks to a fraction of its size.
+ */
+class SaveOFStream : public std::ostream
+{
+public:
+    explicit SaveOFStream(const fs::path& filepath);
+    ~SaveOFStream();
+
+    /**
+     * Finishes the compressed data and closes the file. Sets failbit if any
+     * of it could not be written, which the destructor cannot report.
+     */
+    void close();
+
+private:
+    class Sink;
+
+    std::ofstream _file;
+    std::unique_ptr<Sink> _sink;
+    std::unique_ptr<zstr::ostreambuf> _deflater;
+};
+
+} // namespace elona
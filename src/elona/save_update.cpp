@@ -13,6 +13,14 @@
 namespace
 {
 
+void _update_save_data_15(const fs::path&)
+{
+    // From #16 on, save files are compressed as they are written. Files
+    // written before are still read as they are, so nothing is converted here.
+}
+
+
+
 void _update_save_data(const fs::path& save_dir, int serial_id)
 {
 #define ELONA_CASE(n) \
@@ -37,6 +45,7 @@ void _update_save_data(const fs::path& save_dir, int serial_id)
     case 14:
         throw std::runtime_error{
             "Too old save! Please update the save in v0.5.0 first."};
+        ELONA_CASE(15)
     default: assert(0); break;
     }
 #undef ELONA_CASE
@@ -35,3 +35,16 @@ using SharedId = boost::flyweight<
     boost::flyweights::no_locking>;
 
 } // namespace elona
+
+
+
+/**
+ * The `SharedId` of @a id, a string literal, interned the first time the
+ * expression runs. Constructing a `SharedId` hashes the string and looks it up
+ * in the flyweight factory, which is wasted work for a fixed ID on a hot path.
+ */
+#define ELONA_SHARED_ID(id) \
+    ([]() -> const ::elona::SharedId& { \
+        static const ::elona::SharedId shared_id{std::string{id}}; \
+        return shared_id; \
+    }())
@@ -0,0 +1,325 @@
+#include "simulation.hpp"
+#include <chrono>
+#include <iomanip>
+#include <ostream>
+#include "../util/filepathutil.hpp"
+#include "../util/fnv1a.hpp"
+#include "autopick.hpp"
+#include "character.hpp"
+#include "debug.hpp"
+#include "enums.hpp"
+#include "filesystem.hpp"
+#include "gdata.hpp"
+#include "input_recorder.hpp"
+#include "item.hpp"
+#include "lua_env/event_manager.hpp"
+#include "lua_env/lua_env.hpp"
+#include "lua_env/lua_event/base_event.hpp"
+#include "map.hpp"
+#include "random.hpp"
+#include "save.hpp"
+#include "testing.hpp"
+#include "turn_sequence.hpp"
+#include "variables.hpp"
+
+
+
+namespace
+{
+
+using Clock = std::chrono::steady_clock;
+
+} // namespace
+
+
+
+namespace elona
+{
+namespace simulation
+{
+
+namespace
+{
+
+void _load_save(const std::string& player_id)
+{
+    playerid = player_id;
+    firstturn = 1;
+    load_save_data();
+    mode = 3;
+    initialize_map();
+}
+
+
+
+// Starts from the copy of the save made when the recording started, and
+// seeds the random engine the same way the game did then.
+void _prepare_replay(const fs::path& record_file)
+{
+    auto& recorder = InputRecorder::instance();
+    recorder.start_replaying(record_file);
+    const auto header = recorder.header();
+
+    const auto save_dir = filesystem::dirs::save(header.player_id);
+    if (fs::exists(save_dir))
+    {
+        fs::remove_all(save_dir);
+    }
+    filesystem::copy_recursively(
+        InputRecorder::snapshot_dir(record_file), save_dir);
+
+    randomize(header.seed);
+    Autopick::instance().load(header.player_id);
+    _load_save(header.player_id);
+    lua::lua->get_event_manager().trigger(
+        lua::BaseEvent("core.game_initialized"));
+    randomize(header.seed);
+}
+
+} // namespace
+
+
+
+const char* subsystem_name(Subsystem subsystem)
+{
+    switch (subsystem)
+    {
+    case Subsystem::world: return "world";
+    case Subsystem::scheduler: return "scheduler";
+    case Subsystem::npc: return "npc";
+    case Subsystem::player: return "player";
+    case Subsystem::turn_end: return "turn_end";
+    case Subsystem::map: return "map";
+    case Subsystem::_size: break;
+    }
+    return "";
+}
+
+
+
+void prepare(const Options& options)
+{
+    if (!options.replay.empty())
+    {
+        _prepare_replay(filepathutil::u8path(options.replay));
+        return;
+    }
+
+    // Keep the player alive however long the simulation runs.
+    debug::voldemort = true;
+
+    randomize(options.seed);
+    if (options.save.empty())
+    {
+        testing::start_in_debug_map();
+        randomize(options.seed);
+        for (int i = 0; i < options.npcs; ++i)
+        {
+            map_set_chara_generation_filter();
+            chara_create(-1, dbid, -3, 0);
+        }
+    }
+    else
+    {
+        _load_save(options.save);
+        randomize(options.seed);
+    }
+}
+
+
+
+Report run(const Options& options)
+{
+    Report report;
+    auto result = TurnResult::turn_begin;
+
+    auto& recorder = InputRecorder::instance();
+    const auto replaying = recorder.is_replaying();
+    bool finished = false;
+
+    const auto start = Clock::now();
+    try
+    {
+        while ((replaying || report.player_turns < options.turns) &&
+               !finished && report.stopped_because.empty())
+        {
+            auto subsystem = Subsystem::world;
+            const auto subsystem_start = Clock::now();
+
+            switch (result)
+            {
+            case TurnResult::turn_begin:
+                ++report.world_turns;
+                result = turn_begin();
+                break;
+            case TurnResult::all_turns_finished:
+                result = TurnResult::turn_begin;
+                continue;
+            case TurnResult::pass_one_turn:
+                subsystem = Subsystem::scheduler;
+                result = pass_one_turn(true);
+                break;
+            case TurnResult::pass_one_turn_freeze_time:
+                subsystem = Subsystem::scheduler;
+                result = pass_one_turn(false);
+                break;
+            case TurnResult::pc_turn:
+            case TurnResult::pc_turn_user_error:
+                ++report.player_turns;
+                if (replaying)
+                {
+                    subsystem = Subsystem::player;
+                    result = pc_turn(result == TurnResult::pc_turn);
+                    break;
+                }
+                // Wait, as the "wait" action does.
+                result = TurnResult::turn_end;
+                continue;
+            case TurnResult::npc_turn:
+                subsystem = Subsystem::npc;
+                ++report.npc_turns;
+                result = npc_turn();
+                break;
+            case TurnResult::turn_end:
+                subsystem = Subsystem::turn_end;
+                result = turn_end();
+                break;
+            case TurnResult::initialize_map:
+                subsystem = Subsystem::map;
+                result = initialize_map();
+                break;
+            case TurnResult::exit_map:
+                subsystem = Subsystem::map;
+                result = exit_map();
+                break;
+            case TurnResult::pc_died:
+                report.stopped_because = "the player died";
+                continue;
+            case TurnResult::finish_elona:
+                // The replayed session ended by quitting the game.
+                finished = true;
+                continue;
+            default:
+                if (const auto next = show_turn_menu(result))
+                {
+                    subsystem = Subsystem::player;
+                    result = *next;
+                    break;
+                }
+                report.stopped_because = "unsupported turn result " +
+                    std::to_string(static_cast<int>(result));
+                continue;
+            }
+
+            report.subsystem_seconds[static_cast<size_t>(subsystem)] +=
+                std::chrono::duration<double>(Clock::now() - subsystem_start)
+                    .count();
+        }
+    }
+    catch (const InputRecorder::ReplayFinished&)
+    {
+    }
+    catch (const InputRecorder::ReplayOutOfSync& e)
+    {
+        report.stopped_because = e.what();
+    }
+    report.seconds =
+        std::chrono::duration<double>(Clock::now() - start).count();
+    recorder.stop();
+
+    report.state_hash = hash_state();
+    return report;
+}
+
+
+
+uint64_t hash_state()
+{
+    lib::Fnv1aHasher hasher;
+
+    const auto& date = game_data.date;
+    hasher.add(date.year);
+    hasher.add(date.month);
+    hasher.add(date.day);
+    hasher.add(date.hour);
+    hasher.add(date.minute);
+    hasher.add(date.second);
+    hasher.add(game_data.play_turns);
+    hasher.add(game_data.weather);
+
+    for (const auto& chara : cdata.all())
+    {
+        hasher.add(static_cast<int>(chara.state()));
+        if (chara.state() == Character::State::empty)
+        {
+            continue;
+        }
+        hasher.add(charaid2int(chara.id));
+        hasher.add(chara.position.x);
+        hasher.add(chara.position.y);
+        hasher.add(chara.hp);
+        hasher.add(chara.mp);
+        hasher.add(chara.sp);
+        hasher.add(chara.level);
+        hasher.add(chara.experience);
+        hasher.add(chara.nutrition);
+        hasher.add(chara.turn_cost);
+        hasher.add(chara.gold);
+    }
+
+    for (const auto& item : inv.all())
+    {
+        hasher.add(item.number());
+        if (item.number() == 0)
+        {
+            continue;
+        }
+        hasher.add(itemid2int(item.id));
+        hasher.add(item.position.x);
+        hasher.add(item.position.y);
+        hasher.add(static_cast<int>(item.curse_state));
+        hasher.add(item.param1);
+    }
+
+    return hasher.get();
+}
+
+
+
+void print_report(std::ostream& out, const Report& report)
+{
+    const auto per_second = [&](int count) {
+        return report.seconds > 0 ? count / report.seconds : 0.0;
+    };
+
+    out << std::fixed << std::setprecision(3);
+    out << "Player turns: " << report.player_turns << " ("
+        << per_second(report.player_turns) << "/s)" << std::endl;
+    out << "World turns:  " << report.world_turns << " ("
+        << per_second(report.world_turns) << "/s)" << std::endl;
+    out << "NPC turns:    " << report.npc_turns << " ("
+        << per_second(report.npc_turns) << "/s)" << std::endl;
+    out << "Time:         " << report.seconds << " s" << std::endl;
+
+    out << "Time by subsystem:" << std::endl;
+    for (size_t i = 0; i < subsystem_count; ++i)
+    {
+        const auto seconds = report.subsystem_seconds[i];
+        const auto percent =
+            report.seconds > 0 ? seconds / report.seconds * 100 : 0.0;
+        out << "  " << std::left << std::setw(10)
+            << subsystem_name(static_cast<Subsystem>(i)) << std::right
+            << std::setw(10) << seconds << " s" << std::setw(8) << percent
+            << "%" << std::endl;
+    }
+
+    if (!report.stopped_because.empty())
+    {
+        out << "Stopped early: " << report.stopped_because << std::endl;
+    }
+    out << "State hash:   " << std::hex << std::setw(16) << std::setfill('0')
+        << report.state_hash << std::dec << std::setfill(' ') << std::endl;
+}
+
+} // namespace simulation
+} // namespace elona
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+
+
+
+namespace elona
+{
+namespace simulation
+{
+
+/**
+ * Runs the turn sequence without any player input: whenever the player's
+ * turn comes, they wait, unless an input record is replayed. Meant to measure
+ * the speed of the world simulation and to detect changes in its outcome.
+ */
+struct Options
+{
+    // Number of the player's turns to run.
+    int turns = 1000;
+
+    // Player ID of a save to load. If empty, a debug map is generated.
+    std::string save;
+
+    // Number of random NPCs to add to the debug map.
+    int npcs = 32;
+
+    int seed = 0;
+
+    // Input record to replay on the player's turns instead of waiting. The
+    // save and the seed are taken from the record, and the simulation runs
+    // until all of it has been replayed.
+    std::string replay;
+};
+
+
+
+enum class Subsystem
+{
+    world, // turn_begin(): time, weather and respawning.
+    scheduler, // pass_one_turn(): picks the next actor; per-turn map events.
+    npc, // npc_turn(): AI.
+    player, // pc_turn() and menus: replayed input.
+    turn_end, // turn_end(): hunger, regeneration and status effects.
+    map, // initialize_map() and exit_map().
+
+    _size,
+};
+
+constexpr size_t subsystem_count = static_cast<size_t>(Subsystem::_size);
+
+const char* subsystem_name(Subsystem subsystem);
+
+
+
+struct Report
+{
+    int player_turns = 0;
+    int world_turns = 0;
+    int npc_turns = 0;
+    double seconds = 0;
+    std::array<double, subsystem_count> subsystem_seconds{};
+    uint64_t state_hash = 0;
+
+    // Why the simulation ended before running all turns, if it did.
+    std::string stopped_because;
+};
+
+
+
+/**
+ * Sets up the world as described by @a options. Expects the game to be
+ * initialized with `testing::pre_init()`.
+ */
+void prepare(const Options& options);
+
+Report run(const Options& options);
+
+/**
+ * Hashes the state the simulation changes: date, characters and items.
+ * Stable across runs and platforms for the same seed.
+ */
+uint64_t hash_state();
+
+void print_report(std::ostream& out, const Report& report);
+
+} // namespace simulation
+} // namespace elona
@@ -81,7 +81,7 @@ void status_ailment_damage(
     case StatusAilment::confused:
         if (chara.is_immune_to_confusion())
             return;
-        if (buff_has(chara, "core.hero"))
+        if (buff_has(chara, ELONA_SHARED_ID("core.hero")))
             return;
         if (chara.quality > Quality::great && rnd(chara.level / 2 + 1))
             return;
@@ -187,9 +187,9 @@ void status_ailment_damage(
     case StatusAilment::fear:
         if (chara.is_immune_to_fear())
             return;
-        if (buff_has(chara, "core.holy_shield"))
+        if (buff_has(chara, ELONA_SHARED_ID("core.holy_shield")))
             return;
-        if (buff_has(chara, "core.hero"))
+        if (buff_has(chara, ELONA_SHARED_ID("core.hero")))
             return;
         if (chara.quality > Quality::great && rnd(chara.level / 5 + 1))
             return;
@@ -18,6 +18,7 @@
 #include "i18n.hpp"
 #include "log.hpp"
 #include "macro.hpp"
+#include "message.hpp"
 #include "save.hpp"
 #include "variables.hpp"
 #ifdef ELONA_OS_WINDOWS
@@ -114,8 +115,7 @@ void await(int msec)
     if (defines::is_android &&
         snail::Application::instance().was_focus_lost_just_now())
     {
-        if (player_queried_for_input &&
-            config_get_boolean("core.android.quicksave") &&
+        if (player_queried_for_input && g_config.quicksave() &&
             !std::uncaught_exception())
         {
             ELONA_LOG("gui") << "Focus lost, quicksaving game.";
@@ -477,6 +477,15 @@ void gmode(int mode, int alpha)
 }
 
 
+/**
+ * Returns the mode and the alpha set with @ref gmode on the current window.
+ */
+std::pair<int, int> current_gmode()
+{
+    return snail::hsp::current_gmode();
+}
+
+
 
 /**
  * Copy from source window to the currently selected window with rotation.
@@ -532,6 +541,11 @@ void grotate(
  */
 void gsel(int window_id)
 {
+    if (window_id != ginfo(3))
+    {
+        // Messages are drawn into the window they were written to.
+        Message::instance().flush();
+    }
     snail::hsp::gsel(window_id);
 }
 
@@ -862,7 +876,8 @@ static void _draw_fps()
  */
 void redraw()
 {
-    if (config_get_boolean("core.foobar.show_fps"))
+    Message::instance().flush();
+    if (g_config.show_fps())
     {
         _draw_fps();
     }
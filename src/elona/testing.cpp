@@ -2,7 +2,10 @@
 
 #include <sstream>
 
+#include "../util/fnv1a.hpp"
 #include "../version.hpp"
+#include "area.hpp"
+#include "character.hpp"
 #include "config.hpp"
 #include "ctrl_file.hpp"
 #include "data/types/type_item.hpp"
@@ -12,11 +15,15 @@
 #include "gdata.hpp"
 #include "i18n.hpp"
 #include "init.hpp"
+#include "item.hpp"
 #include "log.hpp"
 #include "lua_env/event_manager.hpp"
 #include "lua_env/lua_env.hpp"
 #include "lua_env/lua_event/base_event.hpp"
+#include "map.hpp"
+#include "message.hpp"
 #include "profile/profile_manager.hpp"
+#include "random.hpp"
 #include "save.hpp"
 #include "variables.hpp"
 
@@ -166,6 +173,52 @@ void run_in_temporary_map(int map, int dungeon_level, std::function<void()> f)
     initialize_map();
 }
 
+void prepare_nefia_floor(int map, int dungeon_level, int seed)
+{
+    game_data.current_map = map;
+    game_data.current_dungeon_level = dungeon_level;
+
+    for (auto&& chara : cdata.others())
+    {
+        chara.set_state(Character::State::empty);
+    }
+    for (int cnt = ELONA_OTHER_INVENTORIES_INDEX; cnt < ELONA_MAX_ITEMS; ++cnt)
+    {
+        inv[cnt].remove();
+    }
+
+    map_data.clear();
+    map_data.current_dungeon_level = dungeon_level;
+    map_data.atlas_number = area_data[map].tile_set;
+    map_data.tileset = area_data[map].tile_type;
+    map_data.type = area_data[map].type;
+    map_data.refresh_type = area_data[map].is_generated_every_time ? 0 : 1;
+    map_data.indoors_flag = area_data[map].is_indoor ? 1 : 2;
+
+    game_data.random_seed = seed;
+    game_data.random_seed_offset = 0;
+    randomize(seed);
+}
+
+uint64_t hash_cell_data()
+{
+    lib::Fnv1aHasher hasher;
+    hasher.add(cell_data.width());
+    hasher.add(cell_data.height());
+    for (int y = 0; y < cell_data.height(); ++y)
+    {
+        for (int x = 0; x < cell_data.width(); ++x)
+        {
+            const auto& cell = cell_data.at(x, y);
+            hasher.add(cell.chip_id_actual);
+            hasher.add(cell.feats);
+            hasher.add(cell.chara_index_plus_one);
+            hasher.add(cell.item_appearances_actual);
+        }
+    }
+    return hasher.get();
+}
+
 void pre_init()
 {
     log::Logger::instance().init();
@@ -195,6 +248,9 @@ void pre_init()
 
     g_config.set_is_test(true);
 
+    // Nothing is ever presented, so messages need not be drawn.
+    Message::instance().set_rendering_enabled(false);
+
     lua::lua->get_event_manager().trigger(
         lua::BaseEvent("core.game_initialized"));
 }
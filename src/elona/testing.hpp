@@ -1,4 +1,5 @@
 #pragma once
+#include <cstdint>
 #include <functional>
 
 #include "filesystem.hpp"
@@ -42,5 +43,19 @@ void start_in_debug_map();
 void start_in_map(int, int);
 void run_in_temporary_map(int, int, std::function<void()>);
 
+/***
+ * Empties the current map and sets it up as floor @a dungeon_level of
+ * dungeon @a map, seeded with @a seed, so that
+ * `generate_random_nefia_layout()` can generate the floor without the rest of
+ * `initialize_map()`.
+ */
+void prepare_nefia_floor(int map, int dungeon_level, int seed);
+
+/***
+ * Returns a hash of the current map's size and of the chip, feats, character
+ * and items of every cell.
+ */
+uint64_t hash_cell_data();
+
 } // namespace testing
 } // namespace elona
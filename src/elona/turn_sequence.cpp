@@ -1,4 +1,5 @@
 #include "turn_sequence.hpp"
+#include "../util/zone_profiler.hpp"
 #include "ability.hpp"
 #include "activity.hpp"
 #include "ai.hpp"
@@ -58,6 +59,8 @@ namespace elona
 
 TurnResult npc_turn()
 {
+    ELONA_PROFILE_ZONE("npc_turn");
+
     int searchfov = 0;
     if (cdata[cc].is_hung_on_sand_bag())
     {
@@ -662,44 +665,54 @@ bool turn_wrapper()
             finished = true;
             break;
 
-            // Menus that don't return success status
-
-        case TurnResult::show_chat_history: result = show_chat_history(); break;
-        case TurnResult::show_message_log: result = show_message_log(); break;
-        case TurnResult::show_journal: result = show_journal(); break;
-        case TurnResult::show_house_board: result = show_house_board(); break;
-        case TurnResult::show_quest_board: result = show_quest_board(); break;
-        case TurnResult::show_skill_list: result = show_skill_list(); break;
-        case TurnResult::show_spell_list:
-            result = show_spell_list();
-            break;
-
-            // Menus with a success status
-
-        case TurnResult::menu_materials:
-            result = menu_materials().turn_result;
-            break;
-        case TurnResult::menu_character_sheet:
-            result = menu_character_sheet_normal().turn_result;
-            break;
-        case TurnResult::menu_equipment:
-            result = menu_equipment().turn_result;
-            break;
-        case TurnResult::menu_feats: result = menu_feats().turn_result; break;
-        case TurnResult::ctrl_inventory:
-            result = ctrl_inventory().turn_result;
-            break;
-
         case TurnResult::all_turns_finished:
             result = TurnResult::turn_begin;
             break;
         case TurnResult::none:
-        default: assert(0); break;
+        default:
+            if (const auto next = show_turn_menu(result))
+            {
+                result = *next;
+            }
+            else
+            {
+                assert(0);
+            }
+            break;
         }
     }
     return finished;
 }
 
+
+
+optional<TurnResult> show_turn_menu(TurnResult menu)
+{
+    switch (menu)
+    {
+        // Menus that don't return success status
+
+    case TurnResult::show_chat_history: return show_chat_history();
+    case TurnResult::show_message_log: return show_message_log();
+    case TurnResult::show_journal: return show_journal();
+    case TurnResult::show_house_board: return show_house_board();
+    case TurnResult::show_quest_board: return show_quest_board();
+    case TurnResult::show_skill_list: return show_skill_list();
+    case TurnResult::show_spell_list: return show_spell_list();
+
+        // Menus with a success status
+
+    case TurnResult::menu_materials: return menu_materials().turn_result;
+    case TurnResult::menu_character_sheet:
+        return menu_character_sheet_normal().turn_result;
+    case TurnResult::menu_equipment: return menu_equipment().turn_result;
+    case TurnResult::menu_feats: return menu_feats().turn_result;
+    case TurnResult::ctrl_inventory: return ctrl_inventory().turn_result;
+
+    default: return none;
+    }
+}
+
 TurnResult pass_turns(bool time)
 {
     bool finished = false;
@@ -720,6 +733,8 @@ TurnResult pass_turns(bool time)
 
 TurnResult turn_begin()
 {
+    lib::g_zone_profiler.end_turn();
+
     int turncost = 0;
     int spd = 0;
     ct = 0;
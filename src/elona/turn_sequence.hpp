@@ -19,6 +19,11 @@ void update_emoicon();
 TurnResult turn_end();
 TurnResult pc_turn(bool advance_time = true);
 
+/**
+ * Shows the menu the player's turn asked for with @a menu, if it is a menu.
+ */
+optional<TurnResult> show_turn_menu(TurnResult menu);
+
 optional<TurnResult> handle_pc_action(std::string& action);
 
 
@@ -180,6 +180,7 @@ optional<TurnResult> handle_pc_action(std::string& action)
         update_scrolling_info();
         update_slight();
         ui_render_non_hud();
+        Message::instance().flush();
         p = windoww / 192;
         for (int i = 0; i < p + 1; ++i)
         {
@@ -12,6 +12,7 @@
 #include "item.hpp"
 #include "lua_env/console.hpp"
 #include "map.hpp"
+#include "message.hpp"
 #include "random.hpp"
 #include "variables.hpp"
 
@@ -48,6 +49,9 @@ constexpr int inf_clockw = 120;
 
 void update_screen_hud()
 {
+    // Pending messages go under the message window, not over it.
+    Message::instance().flush();
+
     gmode(2);
     ap = windoww / 192;
     for (int cnt = 0, cnt_end = (ap + 1); cnt < cnt_end; ++cnt)
@@ -1646,6 +1650,7 @@ void update_slight()
 {
     slight.clear();
     ++msync;
+    visible_cells.begin_update(map_data.width, map_data.height);
 
     const Position center{cdata.player().position.x - (fov_max + 2) / 2,
                           (fov_max + 2) / 2 - cdata.player().position.y};
@@ -1717,6 +1722,7 @@ void update_slight()
                      sy)))
             {
                 mapsync(sx, sy) = msync;
+                visible_cells.add(sx, sy);
                 if (cell_data.at(sx, sy).chara_index_plus_one != 0)
                 {
                     cdata[cell_data.at(sx, sy).chara_index_plus_one - 1]
@@ -1740,6 +1746,8 @@ void update_slight()
         }
     }
 
+    visible_cells.end_update();
+
     // TODO: are they really needed?
     sx = _repx + _repwidth - 1;
     sy = _repy + _repheight - 1;
@@ -0,0 +1,79 @@
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include "elona/simulation.hpp"
+#include "elona/testing.hpp"
+#include "util/backtrace.hpp"
+#include "util/tinyargparser.hpp"
+
+using namespace elona;
+
+
+
+namespace
+{
+
+tinyargparser::ArgParser _make_argparser()
+{
+    return tinyargparser::ArgParser("Elona foobar simulation")
+        .add('t', "turns", "N", "Number of the player's turns to run.")
+        .add('s', "save", "PLAYER_ID", "Load a save instead of a debug map.")
+        .add('n', "npcs", "N", "Number of NPCs to add to the debug map.")
+        .add('r', "seed", "SEED", "Random seed.")
+        .add('p', "replay", "FILE", "Replay an input record on player's turns.")
+        .add('e', "expect-hash", "HASH", "Fail unless the state hash matches.");
+}
+
+
+
+int _to_int(const std::string& s)
+{
+    return static_cast<int>(std::strtol(s.c_str(), nullptr, 10));
+}
+
+} // namespace
+
+
+
+int main(int argc, char** argv)
+{
+    lib::setup_backtrace();
+
+    const auto parser = _make_argparser();
+    const auto args = parser.parse(argc, argv);
+    if (args.has("help"))
+    {
+        std::cout << parser.help() << std::endl;
+        return 0;
+    }
+
+    simulation::Options options;
+    options.turns = _to_int(args.get_or("turns", "1000"));
+    options.save = args.get_or("save", "");
+    options.npcs = _to_int(args.get_or("npcs", "32"));
+    options.seed = _to_int(args.get_or("seed", "0"));
+    options.replay = args.get_or("replay", "");
+
+    testing::pre_init();
+    simulation::prepare(options);
+    const auto report = simulation::run(options);
+    simulation::print_report(std::cout, report);
+    testing::post_run();
+
+    if (!report.stopped_because.empty())
+    {
+        return 1;
+    }
+    if (args.has("expect-hash"))
+    {
+        const auto expected = args.get_or("expect-hash", "");
+        if (std::strtoull(expected.c_str(), nullptr, 16) != report.state_hash)
+        {
+            std::cerr << "State hash mismatch: expected " << expected
+                      << ", got " << std::hex << report.state_hash
+                      << std::endl;
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -106,6 +106,10 @@ public:
     // NOTE: Do not depend on the order of finalization.
     void register_finalizer(std::function<void()> finalizer);
 
+    // Called when the renderer has lost what was drawn to its buffers, e.g.,
+    // after the graphics device was reset.
+    void register_render_targets_reset_handler(std::function<void()> handler);
+
 
     Renderer& get_renderer()
     {
@@ -172,6 +176,7 @@ private:
     std::unique_ptr<Window> _window;
     std::unique_ptr<Renderer> _renderer;
     std::vector<lib::scope_guard> _finalizers;
+    std::vector<std::function<void()>> _render_targets_reset_handlers;
     Window::FullscreenMode _fullscreen_mode = Window::FullscreenMode::windowed;
 
     Application();
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <string>
 
 namespace elona
@@ -18,6 +19,28 @@ void DSSTOP(int);
 void DSSETVOLUME(int, int);
 bool CHECKPLAY(int channel);
 
+struct SoundCacheStats
+{
+    size_t budget; // In bytes.
+    size_t bytes;
+    size_t count;
+    size_t loads;
+    size_t hits;
+    size_t evictions;
+};
+
+/**
+ * Sets how many bytes of decoded sounds are kept around after their channels
+ * have moved on to other sounds. 0 decodes a sound again every time it is
+ * loaded.
+ */
+void set_sound_cache_budget(size_t bytes);
+
+// Decodes @a filepath into the sound cache ahead of its first use.
+void preload_sound(const std::string& filepath);
+
+SoundCacheStats sound_cache_stats();
+
 int DMINIT();
 void DMLOADFNAME(const std::string& filepath, int);
 void DMPLAY(int, int);
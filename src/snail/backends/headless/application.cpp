@@ -55,6 +55,13 @@ void Application::register_finalizer(std::function<void()>)
 
 
 
+void Application::register_render_targets_reset_handler(
+    std::function<void()>)
+{
+}
+
+
+
 void Application::proc_event()
 {
 }
@@ -53,6 +53,25 @@ bool CHECKPLAY(int)
 
 
 
+void set_sound_cache_budget(size_t)
+{
+}
+
+
+
+void preload_sound(const std::string&)
+{
+}
+
+
+
+SoundCacheStats sound_cache_stats()
+{
+    return {};
+}
+
+
+
 int DMINIT()
 {
     return 1;
@@ -75,6 +75,11 @@ void gmode(int, int)
 {
 }
 
+std::pair<int, int> current_gmode()
+{
+    return {2, 255};
+}
+
 
 
 void grotate(int, int, int, int, int, int, int, double)
@@ -101,6 +101,14 @@ void Application::register_finalizer(std::function<void()> finalizer)
 
 
 
+void Application::register_render_targets_reset_handler(
+    std::function<void()> handler)
+{
+    _render_targets_reset_handlers.push_back(std::move(handler));
+}
+
+
+
 void Application::handle_event(const ::SDL_Event& event)
 {
     switch (event.type)
@@ -119,6 +127,13 @@ void Application::handle_event(const ::SDL_Event& event)
     case SDL_FINGERDOWN:
     case SDL_FINGERUP: Input::instance()._handle_event(event.tfinger); break;
     case SDL_WINDOWEVENT: handle_window_event(event.window); break;
+    case SDL_RENDER_TARGETS_RESET:
+    case SDL_RENDER_DEVICE_RESET:
+        for (const auto& handler : _render_targets_reset_handlers)
+        {
+            handler();
+        }
+        break;
     default: break;
     }
 }
@@ -1,8 +1,10 @@
+#include "../../audio.hpp"
+#include <list>
+#include <unordered_map>
+#include <vector>
 #include "../../application.hpp"
 #include "../../detail/sdl.hpp"
 
-#include <vector>
-
 
 
 namespace
@@ -16,11 +18,71 @@ namespace
 
 constexpr int max_channels = 17;
 
+constexpr size_t default_cache_budget = 16 * 1024 * 1024;
 
-std::vector<Mix_Chunk*> chunks;
+
+struct CachedChunk
+{
+    std::string filepath;
+    Mix_Chunk* chunk;
+    size_t bytes;
+    int channel_count; // Chunks still held by a channel are never evicted.
+};
+
+// Decoded sounds, the most recently used first. Temporary channels load a
+// sound for nearly every hit and footstep, so decoded chunks are kept around
+// up to the budget instead of being freed as soon as a channel moves on.
+std::list<CachedChunk> chunk_cache;
+std::unordered_map<std::string, std::list<CachedChunk>::iterator> chunk_index;
+elona::snail::audio::SoundCacheStats cache_stats{
+    default_cache_budget, 0, 0, 0, 0, 0};
+
+std::vector<CachedChunk*> chunks;
 
 Mix_Music* played_music = nullptr;
 
+
+
+CachedChunk& acquire_chunk(const std::string& filepath)
+{
+    const auto it = chunk_index.find(filepath);
+    if (it != chunk_index.end())
+    {
+        ++cache_stats.hits;
+        chunk_cache.splice(chunk_cache.begin(), chunk_cache, it->second);
+        return *it->second;
+    }
+
+    ++cache_stats.loads;
+    auto chunk = elona::snail::detail::enforce_mixer(
+        Mix_LoadWAV(filepath.c_str()));
+    chunk_cache.push_front({filepath, chunk, chunk->alen, 0});
+    chunk_index[filepath] = chunk_cache.begin();
+    cache_stats.bytes += chunk->alen;
+    ++cache_stats.count;
+    return chunk_cache.front();
+}
+
+
+
+void evict_chunks()
+{
+    auto it = chunk_cache.end();
+    while (cache_stats.bytes > cache_stats.budget && it != chunk_cache.begin())
+    {
+        --it;
+        if (it->channel_count > 0)
+            continue;
+
+        ::Mix_FreeChunk(it->chunk);
+        cache_stats.bytes -= it->bytes;
+        --cache_stats.count;
+        ++cache_stats.evictions;
+        chunk_index.erase(it->filepath);
+        it = chunk_cache.erase(it);
+    }
+}
+
 } // namespace
 
 
@@ -44,11 +106,12 @@ int DSINIT()
     Mix_AllocateChannels(max_channels);
     chunks.resize(max_channels);
     Application::instance().register_finalizer([&]() {
-        for (const auto& chunk : chunks)
+        for (const auto& cached : chunk_cache)
         {
-            if (chunk)
-                ::Mix_FreeChunk(chunk);
+            ::Mix_FreeChunk(cached.chunk);
         }
+        chunk_cache.clear();
+        chunk_index.clear();
     });
     return 1;
 }
@@ -57,18 +120,23 @@ int DSINIT()
 
 void DSLOADFNAME(const std::string& filepath, int channel)
 {
-    if (auto chunk = chunks[channel])
-        Mix_FreeChunk(chunk);
-
-    auto chunk = snail::detail::enforce_mixer(Mix_LoadWAV(filepath.c_str()));
-    chunks[channel] = chunk;
+    auto& cached = acquire_chunk(filepath);
+    ++cached.channel_count;
+    if (auto previous = chunks[channel])
+        --previous->channel_count;
+    chunks[channel] = &cached;
+    // Each sound used to be loaded anew at full volume.
+    Mix_Volume(channel, MIX_MAX_VOLUME);
+
+    evict_chunks();
 }
 
 
 
 void DSPLAY(int channel, bool loop)
 {
-    Mix_PlayChannel(channel, chunks[channel], loop ? -1 : 0);
+    const auto cached = chunks[channel];
+    Mix_PlayChannel(channel, cached ? cached->chunk : nullptr, loop ? -1 : 0);
 }
 
 
@@ -82,9 +150,11 @@ void DSSTOP(int channel)
 
 void DSSETVOLUME(int channel, int volume)
 {
-    if (const auto chunk = chunks[channel])
+    // Cached chunks are shared by channels, so set the channel's volume
+    // rather than the chunk's.
+    if (chunks[channel])
     {
-        Mix_VolumeChunk(chunk, volume);
+        Mix_Volume(channel, volume);
     }
 }
 
@@ -97,6 +167,29 @@ bool CHECKPLAY(int channel)
 
 
 
+void set_sound_cache_budget(size_t bytes)
+{
+    cache_stats.budget = bytes;
+    evict_chunks();
+}
+
+
+
+void preload_sound(const std::string& filepath)
+{
+    acquire_chunk(filepath);
+    evict_chunks();
+}
+
+
+
+SoundCacheStats sound_cache_stats()
+{
+    return cache_stats;
+}
+
+
+
 int DMINIT()
 {
     Application::instance().register_finalizer([&]() {
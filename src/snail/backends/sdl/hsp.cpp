@@ -646,6 +646,14 @@ void gmode(int mode, int alpha)
 
 
 
+std::pair<int, int> current_gmode()
+{
+    return {detail::current_tex_buffer().mode,
+            detail::current_tex_buffer().alpha};
+}
+
+
+
 void grotate(
     int window_id,
     int src_x,
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <utility>
 #include "blend_mode.hpp"
 #include "color.hpp"
 #include "filesystem.hpp"
@@ -46,6 +47,7 @@ void gcopy(
     int dst_height);
 int ginfo(int type);
 void gmode(int mode, int alpha);
+std::pair<int, int> current_gmode();
 void grotate(
     int window_id,
     int src_x,
@@ -11,9 +11,14 @@ namespace snail
 {
 
 Image::Image(const fs::path& filepath, optional<Color> keycolor)
+    : Image(Surface{filepath, keycolor})
 {
-    Surface surface{filepath, keycolor};
+}
+
 
+
+Image::Image(Surface surface)
+{
     _ptr.reset(
         detail::enforce_sdl(::SDL_CreateTextureFromSurface(
             Application::instance().get_renderer().ptr(), surface.ptr())),
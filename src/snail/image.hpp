@@ -15,11 +15,21 @@ namespace elona
 namespace snail
 {
 
+class Surface;
+
+
+
 class Image
 {
 public:
     explicit Image(const fs::path& filepath, optional<Color> keycolor = none);
 
+    /**
+     * Uploads an already decoded @a surface. Surfaces may be decoded on any
+     * thread, but images must be created on the main thread.
+     */
+    explicit Image(Surface surface);
+
     explicit Image(::SDL_Texture* ptr);
 
 
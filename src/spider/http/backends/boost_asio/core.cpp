@@ -50,6 +50,7 @@ void init()
 
 void finalize()
 {
+    detail::close_idle_connections();
     work_guard.reset();
     detail::io_context->stop();
     worker_thread->join();
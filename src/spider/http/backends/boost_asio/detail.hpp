@@ -18,6 +18,9 @@ namespace detail
 extern std::unique_ptr<boost::asio::io_context> io_context;
 extern std::unique_ptr<boost::asio::ssl::context> ssl_context;
 
+// Closes the keep-alive connections waiting for reuse.
+void close_idle_connections();
+
 } // namespace detail
 } // namespace http
 } // namespace spider
@@ -10,8 +10,12 @@
 // Official repository: https://github.com/boostorg/beast
 
 #include "../../request.hpp"
+#include <chrono>
 #include <functional>
+#include <mutex>
 #include <string>
+#include <unordered_map>
+#include <vector>
 #include <boost/beast/core.hpp>
 #include <boost/beast/http.hpp>
 #include <boost/optional.hpp>
@@ -62,6 +66,23 @@ beast::http::verb spider2beast_verb(Verb v)
 
 
 
+// Whether sending the request twice has the same effect as sending it once.
+bool is_idempotent(beast::http::verb v)
+{
+    switch (v)
+    {
+    case beast::http::verb::get:
+    case beast::http::verb::head:
+    case beast::http::verb::put:
+    case beast::http::verb::delete_:
+    case beast::http::verb::options:
+    case beast::http::verb::trace: return true;
+    default: return false;
+    }
+}
+
+
+
 // Unfortunately, Boost.Beast currently does not have URL parser.
 struct ParsedURL
 {
@@ -130,13 +151,97 @@ struct ParsedURL
 
 
 
+// An open connection to a host. It outlives the session that opened it when
+// the server allows keep-alive, and then serves later requests to the same
+// host without another name lookup, TCP connect and TLS handshake.
+struct Connection
+{
+    Connection(asio::io_context& io_context, asio::ssl::context& ssl_context)
+        : socket(io_context)
+        , secure_socket(io_context, ssl_context)
+    {
+    }
+
+
+    tcp::socket socket;
+    asio::ssl::stream<tcp::socket> secure_socket;
+    // Bytes the server sent past the previous response, if any.
+    beast::flat_buffer buffer;
+    std::chrono::steady_clock::time_point idle_since;
+};
+
+
+
+// Idle keep-alive connections, keyed by scheme, host and port. Requests are
+// started on the game thread and finish on the asio worker thread, so access
+// is guarded by a mutex.
+class ConnectionPool
+{
+public:
+    std::shared_ptr<Connection> acquire(const std::string& key)
+    {
+        std::lock_guard<std::mutex> lock{_mutex};
+
+        auto& idle = _idle[key];
+        while (!idle.empty())
+        {
+            auto connection = std::move(idle.back());
+            idle.pop_back();
+            if (std::chrono::steady_clock::now() - connection->idle_since <
+                max_idle_time)
+            {
+                return connection;
+            }
+            // Servers drop idle connections after a while; do not bother
+            // trying one which has most likely been closed.
+        }
+        return nullptr;
+    }
+
+
+    void release(
+        const std::string& key,
+        std::shared_ptr<Connection> connection)
+    {
+        std::lock_guard<std::mutex> lock{_mutex};
+
+        auto& idle = _idle[key];
+        if (idle.size() < max_idle_per_host)
+        {
+            connection->idle_since = std::chrono::steady_clock::now();
+            idle.push_back(std::move(connection));
+        }
+    }
+
+
+    void clear()
+    {
+        std::lock_guard<std::mutex> lock{_mutex};
+        _idle.clear();
+    }
+
+
+private:
+    static constexpr size_t max_idle_per_host = 4;
+    static constexpr std::chrono::seconds max_idle_time{30};
+
+    std::mutex _mutex;
+    std::unordered_map<std::string, std::vector<std::shared_ptr<Connection>>>
+        _idle;
+};
+
+constexpr size_t ConnectionPool::max_idle_per_host;
+constexpr std::chrono::seconds ConnectionPool::max_idle_time;
+
+ConnectionPool connection_pool;
+
+
+
 class Session : public std::enable_shared_from_this<Session>
 {
 private:
     using Resolver = tcp::resolver;
     using Socket = tcp::socket;
-    using SecureSocket = asio::ssl::stream<Socket>;
-    using Buffer = beast::flat_buffer;
     using RawRequest = beast::http::request<beast::http::string_body>;
     using RawResponse = beast::http::response<beast::http::string_body>;
     using FullfilledHandler = std::function<void(Response)>;
@@ -146,9 +251,9 @@ private:
 
 public:
     Session(asio::io_context& io_context, asio::ssl::context& ssl_context)
-        : _resolver(io_context)
-        , _socket(io_context)
-        , _secure_socket(io_context, ssl_context)
+        : _io_context(io_context)
+        , _ssl_context(ssl_context)
+        , _resolver(io_context)
     {
     }
 
@@ -175,39 +280,38 @@ public:
             return;
         }
         _setup_request(request, *parsed_url);
+        _response = RawResponse{};
 
         _is_https = parsed_url->is_https;
-        if (_is_https)
+        _host = parsed_url->host;
+        _port = parsed_url->port;
+        _connection_key =
+            (_is_https ? "https://" : "http://") + _host + ":" + _port;
+
+        _connection = connection_pool.acquire(_connection_key);
+        if (_connection)
         {
-            // Set SNI Hostname (many hosts need this to handshake successfully)
-            if (!SSL_set_tlsext_host_name(
-                    _secure_socket.native_handle(), parsed_url->host.c_str()))
-            {
-                boost::system::error_code ec{
-                    static_cast<int>(::ERR_get_error()),
-                    asio::error::get_ssl_category()};
-                throw Error{ec.message() + " " + _url};
-            }
+            _is_reused_connection = true;
+            do_write();
+        }
+        else
+        {
+            open_connection();
         }
-
-        // Look up the domain name
-        auto self = shared_from_this();
-        _resolver.async_resolve(
-            parsed_url->host,
-            parsed_url->port,
-            [this, self](const auto& ec, const auto& results) {
-                on_resolve(ec, results);
-            });
     }
 
 
 
 private:
+    asio::io_context& _io_context;
+    asio::ssl::context& _ssl_context;
     Resolver _resolver;
     bool _is_https;
-    Socket _socket;
-    SecureSocket _secure_socket;
-    Buffer _buffer;
+    std::string _host;
+    std::string _port;
+    std::string _connection_key;
+    std::shared_ptr<Connection> _connection;
+    bool _is_reused_connection = false;
     Request _original_request;
     RawRequest _request;
     RawResponse _response;
@@ -261,6 +365,64 @@ private:
 
 
 
+    void open_connection()
+    {
+        _connection = std::make_shared<Connection>(_io_context, _ssl_context);
+        _is_reused_connection = false;
+
+        if (_is_https)
+        {
+            // Set SNI Hostname (many hosts need this to handshake successfully)
+            if (!SSL_set_tlsext_host_name(
+                    _connection->secure_socket.native_handle(), _host.c_str()))
+            {
+                boost::system::error_code ec{
+                    static_cast<int>(::ERR_get_error()),
+                    asio::error::get_ssl_category()};
+                throw Error{ec.message() + " " + _url};
+            }
+        }
+
+        // Look up the domain name
+        auto self = shared_from_this();
+        _resolver.async_resolve(
+            _host, _port, [this, self](const auto& ec, const auto& results) {
+                on_resolve(ec, results);
+            });
+    }
+
+
+
+    // A reused connection may have been closed by the server while it was
+    // idle, which shows only when it is written to or read from. Then the
+    // request is sent again on a new connection. Once the request has been
+    // sent, the server may already have handled it, so only requests which
+    // are safe to repeat are sent again after a failed read.
+    bool retry_if_reused_connection(bool is_sent)
+    {
+        if (!_is_reused_connection)
+        {
+            return false;
+        }
+        if (is_sent && !is_idempotent(_request.method()))
+        {
+            return false;
+        }
+        _connection.reset();
+        _response = RawResponse{};
+        try
+        {
+            open_connection();
+        }
+        catch (const Error& err)
+        {
+            fail(err);
+        }
+        return true;
+    }
+
+
+
     void on_resolve(const error_code& ec, Resolver::results_type results)
     {
         if (ec)
@@ -272,7 +434,8 @@ private:
         // Make the connection on the IP address we get from a lookup
         auto self = shared_from_this();
         asio::async_connect(
-            _is_https ? _secure_socket.next_layer() : _socket,
+            _is_https ? _connection->secure_socket.next_layer()
+                      : _connection->socket,
             std::begin(results),
             std::end(results),
             [this, self](const auto& ec, const auto&) { on_connect(ec); });
@@ -288,21 +451,17 @@ private:
             return;
         }
 
-        auto self = shared_from_this();
         if (_is_https)
         {
             // Handshake.
-            _secure_socket.async_handshake(
+            auto self = shared_from_this();
+            _connection->secure_socket.async_handshake(
                 asio::ssl::stream_base::client,
                 [this, self](const auto& ec) { on_handshake(ec); });
         }
         else
         {
-            // Send the HTTP request to the remote host
-            beast::http::async_write(
-                _socket, _request, [this, self](const auto& ec, const auto&) {
-                    on_write(ec);
-                });
+            do_write();
         }
     }
 
@@ -316,12 +475,29 @@ private:
             return;
         }
 
+        do_write();
+    }
+
+
+
+    void do_write()
+    {
         // Send the HTTP request to the remote host
         auto self = shared_from_this();
-        beast::http::async_write(
-            _secure_socket,
-            _request,
-            [this, self](const auto& ec, const auto&) { on_write(ec); });
+        if (_is_https)
+        {
+            beast::http::async_write(
+                _connection->secure_socket,
+                _request,
+                [this, self](const auto& ec, const auto&) { on_write(ec); });
+        }
+        else
+        {
+            beast::http::async_write(
+                _connection->socket,
+                _request,
+                [this, self](const auto& ec, const auto&) { on_write(ec); });
+        }
     }
 
 
@@ -330,7 +506,10 @@ private:
     {
         if (ec)
         {
-            fail("Failed to send a request: " + _url);
+            if (!retry_if_reused_connection(false))
+            {
+                fail("Failed to send a request: " + _url);
+            }
             return;
         }
 
@@ -339,16 +518,16 @@ private:
         if (_is_https)
         {
             beast::http::async_read(
-                _secure_socket,
-                _buffer,
+                _connection->secure_socket,
+                _connection->buffer,
                 _response,
                 [this, self](const auto& ec, const auto&) { on_read(ec); });
         }
         else
         {
             beast::http::async_read(
-                _socket,
-                _buffer,
+                _connection->socket,
+                _connection->buffer,
                 _response,
                 [this, self](const auto& ec, const auto&) { on_read(ec); });
         }
@@ -360,24 +539,33 @@ private:
     {
         if (ec)
         {
-            fail("Failed to receive a response: " + _url);
+            if (!retry_if_reused_connection(true))
+            {
+                fail("Failed to receive a response: " + _url);
+            }
             return;
         }
 
-        if (_is_https)
+        if (_response.keep_alive())
+        {
+            // Leave the connection open for the next request to the host.
+            connection_pool.release(_connection_key, std::move(_connection));
+            on_successfully_recieved();
+        }
+        else if (_is_https)
         {
             // Cancel all pending operations.
             error_code ec_;
-            _secure_socket.lowest_layer().cancel(ec_);
+            _connection->secure_socket.lowest_layer().cancel(ec_);
             // Shut down the TLS socket.
             auto self = shared_from_this();
-            _secure_socket.async_shutdown(
+            _connection->secure_socket.async_shutdown(
                 [this, self](const auto& ec) { on_shutdown(ec); });
         }
         else
         {
             error_code ec_;
-            _socket.shutdown(Socket::shutdown_both, ec_);
+            _connection->socket.shutdown(Socket::shutdown_both, ec_);
 
             // not_connected happens sometimes so don't bother reporting it.
             if (ec_ && ec_ != beast::errc::not_connected)
@@ -421,7 +609,7 @@ private:
 
         // Close the lower layer's connection under TLS socket.
         error_code ec_;
-        _secure_socket.lowest_layer().close(ec_);
+        _connection->secure_socket.lowest_layer().close(ec_);
         if (ec_)
         {
             fail("Failed to shutdown the connection: " + _url);
@@ -528,6 +716,18 @@ private:
 
 
 
+namespace detail
+{
+
+void close_idle_connections()
+{
+    connection_pool.clear();
+}
+
+} // namespace detail
+
+
+
 void Request::send(
     std::function<void(Response)> done,
     std::function<void(Error)> failed)
@@ -1,4 +1,7 @@
 #include "../../request.hpp"
+#include <vector>
+#include "../../response.hpp"
+#include "testing.hpp"
 
 
 
@@ -9,10 +12,47 @@ namespace spider
 namespace http
 {
 
-void Request::send(std::function<void(Response)>, std::function<void(Error)>)
+namespace
 {
+
+std::vector<std::function<void(Response)>> pending_requests;
+
+} // namespace
+
+
+
+void Request::send(
+    std::function<void(Response)> done,
+    std::function<void(Error)>)
+{
+    pending_requests.push_back(std::move(done));
 }
 
+
+
+namespace testing
+{
+
+void respond_to_pending_requests(const Response& response)
+{
+    // Handlers may send new requests, which wait for the next call.
+    auto requests = std::move(pending_requests);
+    pending_requests.clear();
+    for (const auto& done : requests)
+    {
+        done(response);
+    }
+}
+
+
+
+size_t pending_request_count()
+{
+    return pending_requests.size();
+}
+
+} // namespace testing
+
 } // namespace http
 } // namespace spider
 } // namespace elona
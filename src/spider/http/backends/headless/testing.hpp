@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstddef>
+#include "../../response.hpp"
+
+
+
+namespace elona
+{
+namespace spider
+{
+namespace http
+{
+namespace testing
+{
+
+// The headless backend never answers by itself; requests wait until a test
+// answers them.
+
+// Answers every request sent so far with `response`.
+void respond_to_pending_requests(const Response& response);
+
+size_t pending_request_count();
+
+} // namespace testing
+} // namespace http
+} // namespace spider
+} // namespace elona
@@ -0,0 +1,50 @@
+#include "../thirdparty/catch2/catch.hpp"
+
+#include "../elona/character.hpp"
+#include "../elona/debug.hpp"
+#include "../elona/enchantment.hpp"
+#include "../elona/item.hpp"
+#include "../elona/itemgen.hpp"
+#include "../elona/testing.hpp"
+#include "../elona/variables.hpp"
+#include "tests.hpp"
+
+TEST_CASE(
+    "Test that cached equipment stats match a full refresh",
+    "[C++: Character]")
+{
+    testing::start_in_debug_map();
+    elona::debug::check_chara_refresh = true;
+
+    auto& chara = elona::cdata.player();
+    elona::body = 0;
+    for (int i = 0; i < 30; ++i)
+    {
+        if (chara.body_parts[i] / 10000 == 5 &&
+            chara.body_parts[i] % 10000 == 0)
+        {
+            elona::body = 100 + i;
+            break;
+        }
+    }
+    REQUIRE(elona::body != 0);
+
+    REQUIRE_SOME(elona::itemcreate(0, 1, -1, -1, 0));
+    Item& i = elona::inv[elona::ci];
+    elona::enchantment_add(i, 10010, 300, 0, false, false, true);
+    elona::enchantment_add(i, 20011, -300, 0, false, false, true);
+    elona::enchantment_add(i, 32, 100, 0, false, false, true);
+    elona::enchantment_add(i, 51, 150, 0, false, false, true);
+    REQUIRE(elona::equip_item(0) == 1);
+
+    REQUIRE_NOTHROW(elona::chara_refresh(0));
+    REQUIRE(chara.is_floating());
+    REQUIRE(chara.extra_shot == 100);
+
+    // Changes to an equipped item are picked up without invalidation.
+    i.curse_state = CurseState::doomed;
+    i.enchantments[0].power += 500;
+    REQUIRE_NOTHROW(elona::chara_refresh(0));
+
+    elona::debug::check_chara_refresh = false;
+}
@@ -66,3 +66,30 @@ TEST_CASE("Test cutname", "[C++: Misc.]")
         cutname(u8"Gentleness of Immortality Sonya", 32) ==
         u8"Gentleness of Immortality Sonya");
 }
+
+
+
+TEST_CASE("Test sort_list_and_listn_by_column1 is stable", "[C++: Misc.]")
+{
+    start_in_debug_map();
+
+    const int keys[] = {3, 1, 2, 1, 3, 0};
+    elona::listmax = 6;
+    for (int i = 0; i < elona::listmax; ++i)
+    {
+        elona::list(0, i) = i;
+        elona::list(1, i) = keys[i];
+        elona::listn(0, i) = std::to_string(i);
+        elona::listn(1, i) = "";
+    }
+
+    elona::sort_list_and_listn_by_column1();
+
+    const int expected[] = {5, 1, 3, 2, 0, 4};
+    for (int i = 0; i < elona::listmax; ++i)
+    {
+        REQUIRE(elona::list(0, i) == expected[i]);
+        REQUIRE(elona::list(1, i) == keys[expected[i]]);
+        REQUIRE(elona::listn(0, i) == std::to_string(expected[i]));
+    }
+}
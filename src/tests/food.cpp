@@ -0,0 +1,105 @@
+#include "../thirdparty/catch2/catch.hpp"
+
+#include <vector>
+#include "../elona/food.hpp"
+#include "../elona/gdata.hpp"
+#include "../elona/item.hpp"
+#include "../elona/itemgen.hpp"
+#include "../elona/random.hpp"
+#include "../elona/testing.hpp"
+#include "../elona/variables.hpp"
+#include "tests.hpp"
+
+namespace
+{
+
+struct FoodState
+{
+    int number;
+    int id;
+    int param3;
+    int image;
+
+    bool operator==(const FoodState& other) const
+    {
+        return number == other.number && id == other.id &&
+            param3 == other.param3 && image == other.image;
+    }
+};
+
+
+
+std::vector<FoodState> simulate_rotting(void (*get_rotten)())
+{
+    testing::start_in_debug_map();
+    elona::randomize(42);
+
+    // Starts from an empty schedule so that every food must be added as it
+    // is created or moved.
+    elona::food_expiration_schedule.invalidate();
+    elona::foods_get_rotten();
+
+    for (int i = 0; i < 20; ++i)
+    {
+        flt();
+        flttypemajor = 57000;
+        itemcreate(0, 0, -1, -1, 0);
+        flt();
+        flttypemajor = 57000;
+        itemcreate(-1, 0, 4 + i % 5, 8 + i / 5, 0);
+    }
+    for (int i = 0; i < 5; ++i)
+    {
+        flt();
+        itemcreate(-1, itemid2int(ItemId::corpse), 4 + i, 14, 0);
+    }
+
+    for (int hour = 0; hour < 3000; ++hour)
+    {
+        ++elona::game_data.date.hour;
+        if (hour == 10)
+        {
+            // Pick up a food from the ground, as `pick_up_item()` does.
+            for (auto&& item : elona::inv.ground())
+            {
+                if (item.number() != 0 && item.material == 35 &&
+                    item.param3 > 0)
+                {
+                    const auto slot = elona::inv_getfreeid(0);
+                    REQUIRE(slot != -1);
+                    elona::item_copy(item.index, slot);
+                    item.remove();
+                    break;
+                }
+            }
+        }
+        get_rotten();
+    }
+
+    std::vector<FoodState> ret;
+    for (const auto& item : elona::inv.all())
+    {
+        ret.push_back(
+            {item.number(), itemid2int(item.id), item.param3, item.image});
+    }
+    return ret;
+}
+
+} // namespace
+
+
+
+TEST_CASE(
+    "Test that scheduled food rotting matches checking every item",
+    "[C++: Food]")
+{
+    const auto fully = simulate_rotting(elona::foods_get_rotten_fully);
+    const auto scheduled = simulate_rotting(elona::foods_get_rotten);
+
+    REQUIRE(fully.size() == scheduled.size());
+    for (size_t i = 0; i < fully.size(); ++i)
+    {
+        INFO("Item index: " << i);
+        REQUIRE(fully[i] == scheduled[i]);
+    }
+}
@@ -0,0 +1,74 @@
+#include "../thirdparty/catch2/catch.hpp"
+
+#include "../elona/filesystem.hpp"
+#include "../elona/input_recorder.hpp"
+#include "../elona/testing.hpp"
+#include "../elona/variables.hpp"
+#include "../util/scope_guard.hpp"
+
+using namespace elona;
+
+
+
+TEST_CASE("Test replaying recorded input", "[C++: Input]")
+{
+    testing::start_in_debug_map();
+    testing::save();
+
+    const auto filepath = filesystem::dirs::tmp() / "input_record.txt";
+    auto& recorder = InputRecorder::instance();
+
+    // Replaying sets them, so they have to be restored for the other tests.
+    const auto running_bk = running;
+    const auto keybd_wait_bk = keybd_wait;
+    lib::scope_guard restore{[&]() {
+        recorder.stop();
+        running = running_bk;
+        keybd_wait = keybd_wait_bk;
+    }};
+
+    recorder.start_recording(filepath, playerid, 1234);
+    recorder.record_action("");
+    recorder.record_action("");
+    running = 1;
+    keybd_wait = 42;
+    recorder.record_action("north");
+    {
+        InputRecorder::ScopedPause pause;
+        recorder.record_action("enter");
+    }
+    recorder.record_action("");
+    recorder.record_prompt(2, 5);
+    recorder.record_text(false, "a name with spaces");
+    recorder.record_action("");
+    recorder.record_action("");
+    recorder.stop();
+    REQUIRE(fs::exists(InputRecorder::snapshot_dir(filepath) / "header.txt"));
+
+    running = 0;
+    keybd_wait = 0;
+    recorder.start_replaying(filepath);
+    REQUIRE(recorder.header().player_id == playerid);
+    REQUIRE(recorder.header().seed == 1234);
+
+    REQUIRE(recorder.replay_action() == "");
+    REQUIRE(recorder.replay_action() == "");
+    REQUIRE(recorder.replay_action() == "north");
+    REQUIRE(running == 1);
+    REQUIRE(keybd_wait == 42);
+
+    // The poll before the prompt is replayed before it.
+    REQUIRE_THROWS_AS(recorder.replay_prompt(), InputRecorder::ReplayOutOfSync);
+    REQUIRE(recorder.replay_action() == "");
+    REQUIRE_THROWS_AS(
+        recorder.replay_action(), InputRecorder::ReplayOutOfSync);
+    REQUIRE(recorder.replay_prompt() == std::make_pair(2, 5));
+    REQUIRE(
+        recorder.replay_text() ==
+        std::make_pair(false, std::string{"a name with spaces"}));
+
+    // So are the polls before the end of the record.
+    REQUIRE(recorder.replay_action() == "");
+    REQUIRE(recorder.replay_action() == "");
+    REQUIRE_THROWS_AS(recorder.replay_action(), InputRecorder::ReplayFinished);
+}
@@ -20,3 +20,30 @@ TEST_CASE("Test that index of copied item is set", "[C++: Item]")
     REQUIRE(elona::inv[elona::ci].index == elona::ci);
     REQUIRE(elona::inv[ti].index == ti);
 }
+
+
+
+TEST_CASE("Test that cached item names follow the item", "[C++: Item]")
+{
+    testing::start_in_debug_map();
+
+    REQUIRE_SOME(itemcreate(-1, itemid2int(PUTITORO_PROTO_ID), 4, 8, 1));
+    Item& i = elona::inv[elona::ci];
+    const auto check = [&]() {
+        REQUIRE(
+            elona::item_name_cache.get(i.index, i.number()) ==
+            elona::itemname(i.index, i.number()));
+    };
+
+    check();
+    i.identify_state = IdentifyState::completely;
+    check();
+    i.curse_state = CurseState::cursed;
+    check();
+    i.set_number(3);
+    check();
+    i.enhancement = 2;
+    check();
+    i.is_poisoned() = true;
+    check();
+}
@@ -50,3 +50,30 @@ lrun("test FOV.you_see", function()
         lequal(FOV.you_see(chara.position), false)
         lequal(FOV.you_see(chara.position.x, chara.position.y), false)
 end)
+
+lrun("test FOV.entered and FOV.left", function()
+        Testing.start_in_debug_map()
+
+        local pos = Chara.player().position
+        FOV.refresh()
+        FOV.refresh()
+        lequal(#FOV.entered(), 0)
+        lequal(#FOV.left(), 0)
+
+        Map.set_tile(pos.x, pos.y + 2, Map.generate_tile(Enums.TileKind.Wall))
+        FOV.refresh()
+        lequal(#FOV.entered(), 0)
+
+        local hidden = false
+        for _, left in ipairs(FOV.left()) do
+           if left.x == pos.x and left.y == pos.y + 5 then
+              hidden = true
+           end
+        end
+        lequal(hidden, true)
+
+        Map.set_tile(pos.x, pos.y + 2, Map.generate_tile(Enums.TileKind.Room))
+        FOV.refresh()
+        lequal(#FOV.left(), 0)
+        lequal(#FOV.entered() > 0, true)
+end)
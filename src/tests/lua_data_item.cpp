@@ -41,3 +41,26 @@ TEST_CASE("test registering item", "[Lua: Data]")
     REQUIRE(data->filter == "/noshop/nodownload/");
     REQUIRE(data->rffilter == "/fish/");
 }
+
+TEST_CASE("test looking up frozen legacy IDs", "[Lua: Data]")
+{
+    elona::lua::LuaEnv lua;
+    auto table = load(lua, "item");
+
+    ItemDB db;
+    db.initialize(lua.get_data_manager().get());
+    db.load_all();
+    db.freeze();
+
+    auto by_id = db["item.putitoro"];
+    auto by_legacy_id = db[9999];
+
+    REQUIRE(by_legacy_id);
+    REQUIRE(&*by_legacy_id == &*by_id);
+    REQUIRE_SOME(db.get_id_from_legacy(9999));
+    REQUIRE(db.get_id_from_legacy(9999)->get() == "item.putitoro");
+    REQUIRE_FALSE(db[9998]);
+
+    db.clear();
+    REQUIRE(db[9999]);
+}
@@ -0,0 +1,150 @@
+#include "../thirdparty/catch2/catch.hpp"
+
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include "../elona/filesystem.hpp"
+#include "../elona/gdata.hpp"
+#include "../elona/mapgen.hpp"
+#include "../elona/mdata.hpp"
+#include "../elona/testing.hpp"
+#include "../util/scope_guard.hpp"
+#include "tests.hpp"
+
+using namespace elona;
+
+
+
+namespace
+{
+
+using FloorKey = std::tuple<int, int, int>;
+
+
+
+uint64_t generate_floor(int rdtype, int dungeon_level, int seed)
+{
+    // prepare_nefia_floor() reseeds the game; later tests expect its seed.
+    const auto random_seed = game_data.random_seed;
+    const auto random_seed_offset = game_data.random_seed_offset;
+    lib::scope_guard restore_seed{[=]() {
+        game_data.random_seed = random_seed;
+        game_data.random_seed_offset = random_seed_offset;
+    }};
+
+    testing::prepare_nefia_floor(
+        static_cast<int>(mdata_t::MapId::lesimas), dungeon_level, seed);
+    if (const auto generated_rdtype = generate_random_nefia_layout(rdtype))
+    {
+        populate_random_nefia(*generated_rdtype);
+    }
+    return testing::hash_cell_data();
+}
+
+
+
+// Reads the recorded hashes of floors, one "rdtype level seed hash" per line.
+std::map<FloorKey, uint64_t> load_golden_hashes()
+{
+    std::map<FloorKey, uint64_t> ret;
+    std::ifstream in{
+        (filesystem::dirs::exe() / u8"tests/data/mapgen_hashes.txt").native()};
+    std::string line;
+    while (std::getline(in, line))
+    {
+        if (line.empty() || line[0] == '#')
+        {
+            continue;
+        }
+        std::istringstream fields{line};
+        int rdtype;
+        int dungeon_level;
+        int seed;
+        uint64_t hash;
+        if (fields >> rdtype >> dungeon_level >> seed >> hash)
+        {
+            ret[FloorKey{rdtype, dungeon_level, seed}] = hash;
+        }
+    }
+    return ret;
+}
+
+} // namespace
+
+
+
+TEST_CASE(
+    "Test that nefia floors of every type are the same for the same seed",
+    "[C++: Mapgen]")
+{
+    testing::start_in_debug_map();
+
+    for (const auto rdtype : {1, 2, 3, 4, 5, 8, 9, 10})
+    {
+        for (const auto dungeon_level : {1, 12, 40})
+        {
+            INFO("rdtype: " << rdtype << ", level: " << dungeon_level);
+            const auto first = generate_floor(rdtype, dungeon_level, 1234);
+            const auto second = generate_floor(rdtype, dungeon_level, 1234);
+            REQUIRE(first == second);
+            REQUIRE(generate_floor(rdtype, dungeon_level, 5678) != first);
+        }
+    }
+}
+
+
+
+TEST_CASE(
+    "Test that nefia floors match their recorded hashes",
+    "[C++: Mapgen]")
+{
+    testing::start_in_debug_map();
+
+    // A change to these hashes means that the same seed generates another
+    // floor. If that is intended, record the new hashes in
+    // tests/data/mapgen_hashes.txt.
+    const auto golden_hashes = load_golden_hashes();
+    for (const auto rdtype : {1, 2, 3, 4, 5, 8, 9, 10})
+    {
+        for (const auto dungeon_level : {1, 12, 40})
+        {
+            for (const auto seed : {1234, 5678})
+            {
+                INFO(
+                    "rdtype: " << rdtype << ", level: " << dungeon_level
+                               << ", seed: " << seed);
+                const auto hash = generate_floor(rdtype, dungeon_level, seed);
+                const auto itr = golden_hashes.find(
+                    FloorKey{rdtype, dungeon_level, seed});
+                if (itr == std::end(golden_hashes))
+                {
+                    // Keep going so that one run prints every missing line.
+                    FAIL_CHECK(
+                        "No recorded hash; add \""
+                        << rdtype << " " << dungeon_level << " " << seed
+                        << " " << hash << "\" to mapgen_hashes.txt");
+                    continue;
+                }
+                REQUIRE(hash == itr->second);
+            }
+        }
+    }
+}
+
+
+
+TEST_CASE(
+    "Test that the floor type chosen by the generator is repeatable",
+    "[C++: Mapgen]")
+{
+    testing::start_in_debug_map();
+
+    for (int seed = 0; seed < 20; ++seed)
+    {
+        INFO("seed: " << seed);
+        REQUIRE(generate_floor(0, 8, seed) == generate_floor(0, 8, seed));
+    }
+}
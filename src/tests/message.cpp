@@ -0,0 +1,52 @@
+#include "../thirdparty/catch2/catch.hpp"
+
+#include "../elona/message.hpp"
+#include "../elona/message_log.hpp"
+#include "../elona/testing.hpp"
+#include "../util/scope_guard.hpp"
+#include "tests.hpp"
+
+
+
+TEST_CASE(
+    "Test that messages are not queued for drawing in headless runs",
+    "[C++: Message]")
+{
+    testing::start_in_debug_map();
+    auto& message = elona::Message::instance();
+
+    const auto lines = elona::message_log.line_size();
+    for (int i = 0; i < 100; ++i)
+    {
+        message.new_turn();
+        elona::txt("The putit is hit.");
+    }
+
+    REQUIRE(message.pending_draw_count() == 0);
+    REQUIRE(elona::message_log.line_size() > lines);
+}
+
+
+
+TEST_CASE(
+    "Test that only the messages still in the window are drawn",
+    "[C++: Message]")
+{
+    testing::start_in_debug_map();
+    auto& message = elona::Message::instance();
+    message.set_rendering_enabled(true);
+    lib::scope_guard disable_rendering{
+        [&]() { message.set_rendering_enabled(false); }};
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        message.new_turn();
+        elona::txt("The ball hits the putit.");
+    }
+    const auto pending = message.pending_draw_count();
+    REQUIRE(pending > 0);
+    REQUIRE(pending < 100);
+
+    message.flush();
+    REQUIRE(message.pending_draw_count() == 0);
+}
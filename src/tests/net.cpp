@@ -0,0 +1,90 @@
+#include "../thirdparty/catch2/catch.hpp"
+
+#include <chrono>
+#include "../elona/config.hpp"
+#include "../elona/net.hpp"
+#include "../elona/testing.hpp"
+#include "../spider/http/backends/headless/testing.hpp"
+#include "../util/scope_guard.hpp"
+#include "../util/spsc_queue.hpp"
+#include "tests.hpp"
+
+using namespace std::literals::chrono_literals;
+
+
+
+TEST_CASE("Test SpscQueue", "[C++: SpscQueue]")
+{
+    lib::SpscQueue<int, 2> queue;
+    REQUIRE(queue.empty());
+    REQUIRE_NONE(queue.pop());
+
+    REQUIRE(queue.push(1));
+    REQUIRE(queue.push(2));
+    REQUIRE_FALSE(queue.push(3));
+
+    REQUIRE(queue.pop() == 1);
+    REQUIRE(queue.push(3));
+    REQUIRE(queue.pop() == 2);
+    REQUIRE(queue.pop() == 3);
+    REQUIRE(queue.empty());
+}
+
+
+
+TEST_CASE(
+    "Test that receiving chats every turn does not wait for the server",
+    "[C++: Net]")
+{
+    testing::start_in_debug_map();
+    elona::config_set_boolean("core.net.is_enabled", true);
+    lib::scope_guard disable_net{
+        []() { elona::config_set_boolean("core.net.is_enabled", false); }};
+
+    // The headless backend never answers, which is the slowest server there
+    // can be. Before chats were fetched in the background, the first call
+    // hung forever.
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < 100; ++i)
+    {
+        REQUIRE(elona::net_receive_chats(true).empty());
+    }
+    REQUIRE(std::chrono::steady_clock::now() - start < 1s);
+}
+
+
+
+TEST_CASE(
+    "Test that chats fetched in the background are received on a later turn",
+    "[C++: Net]")
+{
+    testing::start_in_debug_map();
+    elona::config_set_boolean("core.net.is_enabled", true);
+    elona::config_set_string("core.net.news", "receive");
+    lib::scope_guard disable_net{[]() {
+        elona::config_set_boolean("core.net.is_enabled", false);
+        elona::config_set_string("core.net.news", "disabled");
+    }};
+
+    namespace http = elona::spider::http;
+
+    // Starts a fetch unless an earlier test left one waiting.
+    elona::net_receive_chats(true);
+    REQUIRE(http::testing::pending_request_count() == 1);
+
+    http::Response response;
+    response.status = 200;
+    response.body =
+        R"([{"id": 100000, "kind": 3, "created_at": "2019-01-01T00:00:00Z",)"
+        R"( "message": "news"}])";
+    http::testing::respond_to_pending_requests(response);
+
+    const auto chats = elona::net_receive_chats(true);
+    REQUIRE(chats.size() == 1);
+    REQUIRE(chats[0].id == 100000);
+    REQUIRE(chats[0].kind == elona::ChatKind::news);
+    REQUIRE(chats[0].message == "news");
+
+    // Already delivered.
+    REQUIRE(elona::net_receive_chats(true).empty());
+}
@@ -8,6 +8,8 @@
 #include "../elona/init.hpp"
 #include "../elona/item.hpp"
 #include "../elona/itemgen.hpp"
+#include "../elona/putit.hpp"
+#include "../elona/save_stream.hpp"
 #include "../elona/testing.hpp"
 #include "../elona/variables.hpp"
 #include "tests.hpp"
@@ -135,3 +137,85 @@ TEST_CASE("Test foobar save data compatibility", "[C++: Serialization]")
     load_previous_savefile();
     REQUIRE(elona::foobar_data.is_autodig_enabled == 0);
 }
+
+TEST_CASE("Test compressed save files", "[C++: Serialization]")
+{
+    const auto filepath = filesystem::dirs::tmp() / "compressed.s1";
+    std::vector<int> data(10000);
+    data[42] = 42;
+
+    {
+        SaveOFStream out{filepath};
+        putit::BinaryOArchive::save(out, data);
+    }
+    REQUIRE(fs::file_size(filepath) < data.size() * sizeof(int) / 10);
+
+    std::vector<int> loaded;
+    {
+        SaveIFStream in{filepath};
+        REQUIRE(in.is_compressed());
+        putit::BinaryIArchive::load(in, loaded);
+    }
+    REQUIRE(loaded == data);
+}
+
+TEST_CASE("Test closing save files", "[C++: Serialization]")
+{
+    const auto filepath = filesystem::dirs::tmp() / "closed.s1";
+    const std::string data(1000, 'x');
+
+    SaveOFStream out{filepath};
+    out.write(data.data(), static_cast<std::streamsize>(data.size()));
+    out.close();
+    REQUIRE_FALSE(out.fail());
+    {
+        SaveIFStream in{filepath};
+        using Iterator = std::istreambuf_iterator<char>;
+        const std::string loaded{Iterator{in}, Iterator{}};
+        REQUIRE(loaded == data);
+    }
+
+    SaveOFStream missing_dir{filesystem::dirs::tmp() / "missing" / "x.s1"};
+    missing_dir.write(data.data(), static_cast<std::streamsize>(data.size()));
+    missing_dir.close();
+    REQUIRE(missing_dir.fail());
+}
+
+TEST_CASE("Test uncompressed save files", "[C++: Serialization]")
+{
+    const auto filepath = filesystem::dirs::tmp() / "uncompressed.s1";
+    std::vector<int> data(100, 42);
+
+    putit::BinaryOArchive::save(filepath, data);
+
+    std::vector<int> loaded;
+    {
+        SaveIFStream in{filepath};
+        REQUIRE_FALSE(in.is_compressed());
+        putit::BinaryIArchive::load(in, loaded);
+    }
+    REQUIRE(loaded == data);
+}
+
+TEST_CASE("Test skipping unchanged save files", "[C++: Serialization]")
+{
+    start_in_debug_map();
+    save();
+
+    const auto filepath =
+        filesystem::dirs::save(elona::playerid) / (u8"cdata_"s + mid + ".s2");
+    REQUIRE(fs::exists(filepath));
+    const std::time_t long_ago = 0;
+    fs::last_write_time(filepath, long_ago);
+
+    save();
+    REQUIRE(fs::last_write_time(filepath) == long_ago);
+
+    REQUIRE(chara_create(-1, charaid2int(PUTIT_PROTO_ID), 4, 8));
+    save();
+    REQUIRE(fs::last_write_time(filepath) != long_ago);
+
+    fs::remove(filepath);
+    save();
+    REQUIRE(fs::exists(filepath));
+}
@@ -1,5 +1,10 @@
 #include "../thirdparty/catch2/catch.hpp"
 
+#include <chrono>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
 #include "../elona/config.hpp"
 #include "../elona/enums.hpp"
 #include "../elona/i18n.hpp"
@@ -9,6 +14,7 @@
 #include "../elona/lua_env/export_manager.hpp"
 #include "../elona/lua_env/mod_manager.hpp"
 #include "../elona/variables.hpp"
+#include "../util/zone_profiler.hpp"
 #include "tests.hpp"
 
 namespace elona
@@ -130,3 +136,170 @@ return exports
 
 } // namespace testing
 } // namespace elona
+
+
+
+namespace
+{
+
+using lib::g_zone_profiler;
+using ZoneStats = lib::ZoneProfiler::ZoneStats;
+
+
+
+// Enables the global profiler until destroyed, starting from no recorded
+// zones.
+struct ScopedZoneProfiling
+{
+    ScopedZoneProfiling()
+    {
+        g_zone_profiler.set_enabled(true);
+    }
+
+    ~ScopedZoneProfiling()
+    {
+        g_zone_profiler.set_enabled(false);
+        g_zone_profiler.reset();
+    }
+};
+
+
+
+const ZoneStats* find_zone(
+    const std::vector<ZoneStats>& stats,
+    const std::string& name)
+{
+    for (const auto& zone : stats)
+    {
+        if (zone.name == name)
+        {
+            return &zone;
+        }
+    }
+    return nullptr;
+}
+
+
+
+size_t count_substrings(const std::string& str, const std::string& sub)
+{
+    size_t count = 0;
+    for (auto pos = str.find(sub); pos != std::string::npos;
+         pos = str.find(sub, pos + sub.size()))
+    {
+        ++count;
+    }
+    return count;
+}
+
+} // namespace
+
+
+
+TEST_CASE("Test that disabled zones record nothing", "[C++: Util]")
+{
+    g_zone_profiler.reset();
+    {
+        lib::ZoneProfiler::Zone zone{"disabled"};
+    }
+    g_zone_profiler.end_turn();
+
+    REQUIRE(g_zone_profiler.last_turn().empty());
+}
+
+
+
+TEST_CASE("Test nested zones", "[C++: Util]")
+{
+    ScopedZoneProfiling profiling;
+    {
+        lib::ZoneProfiler::Zone outer{"outer"};
+        for (int i = 0; i < 2; ++i)
+        {
+            lib::ZoneProfiler::Zone inner{"inner"};
+        }
+    }
+    g_zone_profiler.end_turn();
+
+    const auto stats = g_zone_profiler.last_turn();
+    REQUIRE(stats.size() == 2);
+    REQUIRE(stats[0].seconds >= stats[1].seconds);
+
+    const auto outer = find_zone(stats, "outer");
+    const auto inner = find_zone(stats, "inner");
+    REQUIRE(outer != nullptr);
+    REQUIRE(inner != nullptr);
+    REQUIRE(outer->count == 1);
+    REQUIRE(inner->count == 2);
+    REQUIRE(outer->seconds >= inner->seconds);
+
+    // Only the outermost zones add up to the time of the turn.
+    REQUIRE(g_zone_profiler.slowest_turn_seconds() == outer->seconds);
+}
+
+
+
+TEST_CASE(
+    "Test that end_turn() keeps the last and the slowest turn",
+    "[C++: Util]")
+{
+    ScopedZoneProfiling profiling;
+    {
+        lib::ZoneProfiler::Zone zone{"slow"};
+        std::this_thread::sleep_for(std::chrono::milliseconds{5});
+    }
+    g_zone_profiler.end_turn();
+    {
+        lib::ZoneProfiler::Zone zone{"fast"};
+    }
+    g_zone_profiler.end_turn();
+
+    const auto last = g_zone_profiler.last_turn();
+    REQUIRE(last.size() == 1);
+    REQUIRE(last[0].name == std::string{"fast"});
+
+    const auto slowest = g_zone_profiler.slowest_turn();
+    REQUIRE(slowest.size() == 1);
+    REQUIRE(slowest[0].name == std::string{"slow"});
+    REQUIRE(g_zone_profiler.slowest_turn_seconds() >= 0.005);
+
+    // A turn without zones does not replace the last one.
+    g_zone_profiler.end_turn();
+    REQUIRE(g_zone_profiler.last_turn().size() == 1);
+    REQUIRE(g_zone_profiler.last_turn()[0].name == std::string{"fast"});
+}
+
+
+
+TEST_CASE("Test the Chrome trace output", "[C++: Util]")
+{
+    ScopedZoneProfiling profiling;
+
+    std::ostringstream empty;
+    g_zone_profiler.write_chrome_trace(empty);
+    REQUIRE(
+        empty.str() == "{\"traceEvents\":[\n],\"displayTimeUnit\":\"ms\"}\n");
+
+    {
+        lib::ZoneProfiler::Zone outer{"outer"};
+        lib::ZoneProfiler::Zone inner{"inner"};
+    }
+    std::ostringstream out;
+    g_zone_profiler.write_chrome_trace(out);
+    const auto trace = out.str();
+
+    REQUIRE(trace.find("{\"traceEvents\":[\n{") == 0);
+    const std::string end = "}\n],\"displayTimeUnit\":\"ms\"}\n";
+    REQUIRE(trace.size() > end.size());
+    REQUIRE(trace.substr(trace.size() - end.size()) == end);
+    REQUIRE(count_substrings(trace, "\"ph\":\"X\"") == 2);
+    REQUIRE(count_substrings(trace, "\"pid\":1,\"tid\":1}") == 2);
+
+    // Events are written as their zones end, the inner one first.
+    const auto inner = trace.find("{\"name\":\"inner\",\"ph\":\"X\"");
+    const auto outer = trace.find("{\"name\":\"outer\",\"ph\":\"X\"");
+    REQUIRE(inner != std::string::npos);
+    REQUIRE(outer != std::string::npos);
+    REQUIRE(inner < outer);
+    REQUIRE(trace.find("},\n{\"name\":\"outer\"") != std::string::npos);
+}
@@ -0,0 +1,199 @@
+#include "allocation_profiler.hpp"
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <new>
+
+namespace
+{
+
+// Index into the profiler's counters; 0 means "no scope".
+thread_local size_t current_subsystem = 0;
+
+std::mutex register_mutex;
+
+} // namespace
+
+
+
+namespace lib
+{
+
+AllocationProfiler g_allocation_profiler;
+
+
+
+AllocationProfiler::Scope::Scope(size_t index)
+    : _previous(current_subsystem)
+{
+    current_subsystem = index;
+}
+
+
+
+AllocationProfiler::Scope::~Scope()
+{
+    current_subsystem = _previous;
+}
+
+
+
+size_t AllocationProfiler::subsystem_index(const char* subsystem)
+{
+    const auto find = [&]() -> size_t {
+        const auto size = _size.load();
+        for (size_t i = 1; i <= size; ++i)
+        {
+            const auto name = _counters[i].subsystem.load();
+            if (name == subsystem || std::strcmp(name, subsystem) == 0)
+            {
+                return i;
+            }
+        }
+        return 0;
+    };
+
+    if (const auto index = find())
+    {
+        return index;
+    }
+
+    std::lock_guard<std::mutex> lock{register_mutex};
+    if (const auto index = find())
+    {
+        return index;
+    }
+    const auto index = _size.load() + 1;
+    if (index >= max_subsystems)
+    {
+        return 0; // Full; count it as unscoped.
+    }
+    _counters[index].subsystem = subsystem;
+    _size = index;
+    return index;
+}
+
+
+
+const AllocationProfiler::Counter* AllocationProfiler::_find(
+    const char* subsystem) const
+{
+    const auto size = _size.load();
+    for (size_t i = 1; i <= size; ++i)
+    {
+        if (std::strcmp(_counters[i].subsystem.load(), subsystem) == 0)
+        {
+            return &_counters[i];
+        }
+    }
+    return nullptr;
+}
+
+
+
+void AllocationProfiler::record(size_t bytes) noexcept
+{
+    auto& counter = _counters[current_subsystem];
+    counter.count.fetch_add(1, std::memory_order_relaxed);
+    counter.bytes.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+
+
+size_t AllocationProfiler::count(const char* subsystem) const
+{
+    const auto counter = _find(subsystem);
+    return counter ? counter->count.load() : 0;
+}
+
+
+
+size_t AllocationProfiler::bytes(const char* subsystem) const
+{
+    const auto counter = _find(subsystem);
+    return counter ? counter->bytes.load() : 0;
+}
+
+
+
+std::vector<AllocationProfiler::Stats> AllocationProfiler::stats() const
+{
+    std::vector<Stats> result;
+    const auto size = _size.load();
+    for (size_t i = 0; i <= size; ++i)
+    {
+        const auto count = _counters[i].count.load();
+        if (count == 0)
+        {
+            continue;
+        }
+        const auto name = _counters[i].subsystem.load();
+        result.push_back(
+            {name ? name : "(unscoped)", count, _counters[i].bytes.load()});
+    }
+    return result;
+}
+
+
+
+void AllocationProfiler::reset()
+{
+    for (auto&& counter : _counters)
+    {
+        counter.count = 0;
+        counter.bytes = 0;
+    }
+}
+
+} // namespace lib
+
+
+
+#ifdef ELONA_PROFILE_ALLOCATIONS
+
+void* operator new(size_t size)
+{
+    lib::g_allocation_profiler.record(size);
+    if (const auto ptr = std::malloc(size == 0 ? 1 : size))
+    {
+        return ptr;
+    }
+    throw std::bad_alloc{};
+}
+
+
+
+void* operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+
+
+void operator delete[](void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+
+
+void operator delete(void* ptr, size_t) noexcept
+{
+    std::free(ptr);
+}
+
+
+
+void operator delete[](void* ptr, size_t) noexcept
+{
+    std::free(ptr);
+}
+
+#endif
@@ -0,0 +1,105 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+namespace lib
+{
+
+/**
+ * Counts heap allocations made through the global operator new, attributed to
+ * the innermost active subsystem scope on the current thread.
+ *
+ * Counting only happens when built with ELONA_PROFILE_ALLOCATIONS (the bench
+ * runner defines it); otherwise `ELONA_ALLOCATION_SCOPE` expands to nothing
+ * and the global operator new is left alone.
+ */
+class AllocationProfiler
+{
+public:
+    static constexpr size_t max_subsystems = 32;
+
+    struct Stats
+    {
+        const char* subsystem;
+        size_t count;
+        size_t bytes;
+    };
+
+
+    /**
+     * Attributes allocations made on this thread to the subsystem at
+     * @a index, as returned by `subsystem_index()`, until destroyed. Scopes
+     * nest; the innermost one wins.
+     */
+    class Scope
+    {
+    public:
+        explicit Scope(size_t index);
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        size_t _previous;
+    };
+
+
+    /**
+     * Returns the index of the counters of @a subsystem, registering it on
+     * the first call. @a subsystem must be a string literal. The index does
+     * not change, so call sites look it up once.
+     */
+    size_t subsystem_index(const char* subsystem);
+
+    void record(size_t bytes) noexcept;
+
+    size_t count(const char* subsystem) const;
+    size_t bytes(const char* subsystem) const;
+
+    // Returns the counters of all subsystems which allocated at least once.
+    std::vector<Stats> stats() const;
+
+    void reset();
+
+
+private:
+    struct Counter
+    {
+        std::atomic<const char*> subsystem;
+        std::atomic<size_t> count;
+        std::atomic<size_t> bytes;
+    };
+
+    const Counter* _find(const char* subsystem) const;
+
+    // Slot 0 is used for allocations outside of any scope.
+    std::array<Counter, max_subsystems> _counters;
+    std::atomic<size_t> _size;
+};
+
+extern AllocationProfiler g_allocation_profiler;
+
+} // namespace lib
+
+
+
+#define ELONA_ALLOCATION_SCOPE_CONCAT_INNER(a, b) a##b
+#define ELONA_ALLOCATION_SCOPE_CONCAT(a, b) \
+    ELONA_ALLOCATION_SCOPE_CONCAT_INNER(a, b)
+
+#ifdef ELONA_PROFILE_ALLOCATIONS
+#define ELONA_ALLOCATION_SCOPE(subsystem) \
+    static const size_t ELONA_ALLOCATION_SCOPE_CONCAT( \
+        elona_allocation_index_, __LINE__) = \
+        ::lib::g_allocation_profiler.subsystem_index(subsystem); \
+    ::lib::AllocationProfiler::Scope ELONA_ALLOCATION_SCOPE_CONCAT( \
+        elona_allocation_scope_, __LINE__) \
+    { \
+        ELONA_ALLOCATION_SCOPE_CONCAT(elona_allocation_index_, __LINE__) \
+    }
+#else
+#define ELONA_ALLOCATION_SCOPE(subsystem) ((void)0)
+#endif
@@ -0,0 +1,35 @@
+#pragma once
+#include <cstdint>
+
+namespace lib
+{
+
+/**
+ * 64-bit FNV-1a hash of a sequence of integers. Unlike std::hash, it gives the
+ * same result everywhere, so hashes can be kept and compared across builds.
+ */
+class Fnv1aHasher
+{
+public:
+    void add(int64_t value)
+    {
+        const auto bits = static_cast<uint64_t>(value);
+        for (int i = 0; i < 8; ++i)
+        {
+            _hash ^= (bits >> (i * 8)) & 0xff;
+            _hash *= 0x100000001b3ULL;
+        }
+    }
+
+
+    uint64_t get() const
+    {
+        return _hash;
+    }
+
+
+private:
+    uint64_t _hash = 0xcbf29ce484222325ULL;
+};
+
+} // namespace lib
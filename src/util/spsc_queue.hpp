@@ -0,0 +1,69 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <boost/optional.hpp>
+
+namespace lib
+{
+
+/**
+ * Bounded lock-free queue for exactly one producer thread and one consumer
+ * thread. Neither side ever waits: `push()` fails when the queue is full and
+ * `pop()` returns none when it is empty.
+ */
+template <typename T, size_t Capacity>
+class SpscQueue
+{
+public:
+    bool push(T value)
+    {
+        const auto tail = _tail.load(std::memory_order_relaxed);
+        const auto next = _next(tail);
+        if (next == _head.load(std::memory_order_acquire))
+        {
+            return false; // Full.
+        }
+        _slots[tail] = std::move(value);
+        _tail.store(next, std::memory_order_release);
+        return true;
+    }
+
+
+    boost::optional<T> pop()
+    {
+        const auto head = _head.load(std::memory_order_relaxed);
+        if (head == _tail.load(std::memory_order_acquire))
+        {
+            return boost::none; // Empty.
+        }
+        boost::optional<T> value{std::move(_slots[head])};
+        _slots[head] = T{};
+        _head.store(_next(head), std::memory_order_release);
+        return value;
+    }
+
+
+    bool empty() const
+    {
+        return _head.load(std::memory_order_acquire) ==
+            _tail.load(std::memory_order_acquire);
+    }
+
+
+private:
+    // One slot is always left unused to tell a full queue from an empty one.
+    static constexpr size_t _size = Capacity + 1;
+
+    static size_t _next(size_t index)
+    {
+        return (index + 1) % _size;
+    }
+
+    std::array<T, _size> _slots;
+    std::atomic<size_t> _head{0};
+    std::atomic<size_t> _tail{0};
+};
+
+} // namespace lib
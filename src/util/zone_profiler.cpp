@@ -0,0 +1,187 @@
+#include "zone_profiler.hpp"
+#include <algorithm>
+#include <cstring>
+#include <ostream>
+
+namespace
+{
+
+using ZoneStats = lib::ZoneProfiler::ZoneStats;
+
+
+
+void add_to(std::vector<ZoneStats>& stats, const char* name, double seconds)
+{
+    const auto it = std::find_if(
+        stats.begin(), stats.end(), [&](const ZoneStats& zone) {
+            return zone.name == name || std::strcmp(zone.name, name) == 0;
+        });
+    if (it == stats.end())
+    {
+        stats.push_back({name, 1, seconds});
+    }
+    else
+    {
+        ++it->count;
+        it->seconds += seconds;
+    }
+}
+
+
+
+std::vector<ZoneStats> sorted(std::vector<ZoneStats> stats)
+{
+    std::sort(
+        stats.begin(), stats.end(), [](const auto& a, const auto& b) {
+            return a.seconds > b.seconds;
+        });
+    return stats;
+}
+
+} // namespace
+
+
+
+namespace lib
+{
+
+ZoneProfiler g_zone_profiler;
+
+
+
+ZoneProfiler::Zone::Zone(const char* name)
+    : _name(name)
+    , _is_recording(g_zone_profiler.is_enabled())
+{
+    if (_is_recording)
+    {
+        ++g_zone_profiler._depth;
+        _start = Clock::now();
+    }
+}
+
+
+
+ZoneProfiler::Zone::~Zone()
+{
+    if (_is_recording)
+    {
+        // Zones left open across `reset()` must not push the depth below 0.
+        auto& depth = g_zone_profiler._depth;
+        depth = std::max(depth - 1, 0);
+        g_zone_profiler._record(_name, _start, depth);
+    }
+}
+
+
+
+void ZoneProfiler::set_enabled(bool enabled)
+{
+    if (_is_enabled == enabled)
+    {
+        return;
+    }
+    _is_enabled = enabled;
+    if (enabled)
+    {
+        reset();
+    }
+}
+
+
+
+void ZoneProfiler::end_turn()
+{
+    if (_current_turn.empty())
+    {
+        return;
+    }
+    if (_current_turn_seconds > _slowest_turn_seconds)
+    {
+        _slowest_turn = _current_turn;
+        _slowest_turn_seconds = _current_turn_seconds;
+    }
+    _last_turn = std::move(_current_turn);
+    _current_turn.clear();
+    _current_turn_seconds = 0;
+}
+
+
+
+std::vector<ZoneProfiler::ZoneStats> ZoneProfiler::last_turn() const
+{
+    return sorted(_last_turn);
+}
+
+
+
+std::vector<ZoneProfiler::ZoneStats> ZoneProfiler::slowest_turn() const
+{
+    return sorted(_slowest_turn);
+}
+
+
+
+void ZoneProfiler::write_chrome_trace(std::ostream& out) const
+{
+    using std::chrono::duration_cast;
+    using std::chrono::microseconds;
+
+    // Zone names are identifiers, so they need no escaping.
+    out << "{\"traceEvents\":[";
+    bool first = true;
+    for (const auto& event : _events)
+    {
+        if (!first)
+        {
+            out << ",";
+        }
+        first = false;
+        out << "\n{\"name\":\"" << event.name << "\",\"ph\":\"X\",\"ts\":"
+            << duration_cast<microseconds>(event.start - _epoch).count()
+            << ",\"dur\":" << duration_cast<microseconds>(event.duration).count()
+            << ",\"pid\":1,\"tid\":1}";
+    }
+    out << "\n],\"displayTimeUnit\":\"ms\"}\n";
+}
+
+
+
+void ZoneProfiler::reset()
+{
+    _depth = 0;
+    _epoch = Clock::now();
+    _events.clear();
+    _current_turn.clear();
+    _current_turn_seconds = 0;
+    _last_turn.clear();
+    _slowest_turn.clear();
+    _slowest_turn_seconds = 0;
+}
+
+
+
+void ZoneProfiler::_record(
+    const char* name,
+    Clock::time_point start,
+    int depth)
+{
+    const auto duration = Clock::now() - start;
+    const auto seconds = std::chrono::duration<double>(duration).count();
+
+    add_to(_current_turn, name, seconds);
+    if (depth == 0)
+    {
+        _current_turn_seconds += seconds;
+    }
+
+    if (_events.size() >= max_events)
+    {
+        _events.erase(
+            _events.begin(),
+            _events.begin() + static_cast<std::ptrdiff_t>(max_events / 2));
+    }
+    _events.push_back({name, start, duration});
+}
+
+} // namespace lib
@@ -0,0 +1,127 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <iosfwd>
+#include <vector>
+
+namespace lib
+{
+
+/**
+ * Measures the time spent in named zones of code and sums it up turn by turn,
+ * to find out where a slow turn went.
+ *
+ * Zones are only compiled in with ELONA_PROFILE_ZONES (debug builds define
+ * it); otherwise `ELONA_PROFILE_ZONE` expands to nothing. Even then nothing is
+ * recorded until the profiler is enabled. Zones must only be entered on the
+ * main thread.
+ */
+class ZoneProfiler
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // Trace events beyond this many drop the oldest half.
+    static constexpr size_t max_events = 200000;
+
+    struct ZoneStats
+    {
+        const char* name;
+        size_t count;
+        double seconds; // Including the zones nested in it.
+    };
+
+
+    /**
+     * Times the code until destroyed as zone @a name, which must be a string
+     * literal.
+     */
+    class Zone
+    {
+    public:
+        explicit Zone(const char* name);
+        ~Zone();
+
+        Zone(const Zone&) = delete;
+        Zone& operator=(const Zone&) = delete;
+
+    private:
+        const char* _name;
+        Clock::time_point _start;
+        bool _is_recording;
+    };
+
+
+    bool is_enabled() const
+    {
+        return _is_enabled;
+    }
+
+    void set_enabled(bool enabled);
+
+    /**
+     * Ends the current turn. Call it once at the start of every turn.
+     */
+    void end_turn();
+
+    // The zones of the last finished turn, the slowest first.
+    std::vector<ZoneStats> last_turn() const;
+
+    // The zones of the slowest turn so far, the slowest first.
+    std::vector<ZoneStats> slowest_turn() const;
+
+    // The time spent in the outermost zones of the slowest turn so far.
+    double slowest_turn_seconds() const
+    {
+        return _slowest_turn_seconds;
+    }
+
+    /**
+     * Writes every recorded zone in the Chrome trace event format, which
+     * chrome://tracing and Perfetto can open.
+     */
+    void write_chrome_trace(std::ostream& out) const;
+
+    void reset();
+
+
+private:
+    struct Event
+    {
+        const char* name;
+        Clock::time_point start;
+        Clock::duration duration;
+    };
+
+    void _record(const char* name, Clock::time_point start, int depth);
+
+    bool _is_enabled = false;
+    int _depth = 0;
+    Clock::time_point _epoch = Clock::now();
+    std::vector<Event> _events;
+    std::vector<ZoneStats> _current_turn;
+    double _current_turn_seconds = 0;
+    std::vector<ZoneStats> _last_turn;
+    std::vector<ZoneStats> _slowest_turn;
+    double _slowest_turn_seconds = 0;
+};
+
+extern ZoneProfiler g_zone_profiler;
+
+} // namespace lib
+
+
+
+#define ELONA_PROFILE_ZONE_CONCAT_INNER(a, b) a##b
+#define ELONA_PROFILE_ZONE_CONCAT(a, b) ELONA_PROFILE_ZONE_CONCAT_INNER(a, b)
+
+#ifdef ELONA_PROFILE_ZONES
+#define ELONA_PROFILE_ZONE(name) \
+    ::lib::ZoneProfiler::Zone ELONA_PROFILE_ZONE_CONCAT( \
+        elona_profile_zone_, __LINE__) \
+    { \
+        name \
+    }
+#else
+#define ELONA_PROFILE_ZONE(name) ((void)0)
+#endif